@@ -0,0 +1,102 @@
+#include "arena.h"
+
+#include "gamemanager.h"
+#include "networkclient.h"
+
+#include <QDebug>
+#include <QTcpSocket>
+
+// How long to wait for more players before starting with the ones we have
+#define ARENA_START_DELAY 10000
+
+Arena::Arena(int id, QObject *parent) : QObject(parent),
+    m_id(id),
+    m_maxRounds(MAX_ROUNDS),
+    m_maxPlayers(DEFAULT_MAX_PLAYERS),
+    m_interestRadius(0),
+    m_tickInterval(DEFAULT_TICKINTERVAL),
+    m_manager(nullptr),
+    m_startTimer(nullptr)
+{
+}
+
+void Arena::start()
+{
+    m_manager = new GameManager(nullptr, this);
+    m_manager->setMaxRounds(m_maxRounds);
+    m_manager->setMaxPlayers(m_maxPlayers);
+    m_manager->setInterestRadius(m_interestRadius);
+    m_manager->setTickInterval(m_tickInterval);
+    m_manager->setCountdownDuration(0);
+    m_manager->setRecordingDirectory(m_recordingDirectory);
+    m_manager->setRoundResultsFileName("results-arena" + QString::number(m_id) + ".jsonl");
+
+    m_startTimer = new QTimer(this);
+    m_startTimer->setInterval(ARENA_START_DELAY);
+    m_startTimer->setSingleShot(true);
+
+    connect(m_startTimer, &QTimer::timeout, this, &Arena::startIfReady);
+    connect(m_manager, &GameManager::playersChanged, this, &Arena::onPlayersChanged);
+    connect(m_manager, &GameManager::gameRunningChanged, this, &Arena::onPlayersChanged);
+
+    // Queued, so GameManager is done writing the scores before we kick everyone
+    connect(m_manager, &GameManager::roundsPlayedChanged, this, &Arena::onRoundsPlayedChanged, Qt::QueuedConnection);
+
+    onPlayersChanged();
+}
+
+void Arena::addConnection(qintptr socketDescriptor)
+{
+    if (m_manager->isGameRunning() || m_manager->playerCount() >= m_manager->maxPlayerCount()) {
+        emit connectionRejected(socketDescriptor);
+        return;
+    }
+
+    QTcpSocket *socket = new QTcpSocket(m_manager);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        qWarning() << "Arena" << m_id << "unable to use connection" << socket->errorString();
+        delete socket;
+        return;
+    }
+
+    m_manager->addPlayer(new NetworkClient(socket));
+
+    if (m_manager->playerCount() >= m_manager->maxPlayerCount()) {
+        startIfReady();
+    } else {
+        m_startTimer->start();
+    }
+}
+
+void Arena::onPlayersChanged()
+{
+    emit statusChanged(m_id, m_manager->playerCount(), m_manager->isGameRunning());
+}
+
+void Arena::onRoundsPlayedChanged()
+{
+    if (!m_manager->isGameRunning() || m_manager->roundsPlayed() < m_manager->maxRounds()) {
+        return;
+    }
+
+    qDebug() << "Arena" << m_id << "finished a game";
+
+    m_manager->stopGame();
+
+    // Make room for the next ones
+    for (int i=m_manager->playerCount() - 1; i>=0; i--) {
+        m_manager->kick(i);
+    }
+}
+
+void Arena::startIfReady()
+{
+    m_startTimer->stop();
+
+    if (m_manager->isGameRunning() || m_manager->playerCount() < 2) {
+        return;
+    }
+
+    qDebug() << "Arena" << m_id << "starting with" << m_manager->playerCount() << "players";
+    m_manager->startGame();
+}
@@ -0,0 +1,56 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+class GameManager;
+
+// One headless game, living on its own thread. The Lobby hands it
+// connections, and it starts playing when it is full, or when nobody new
+// has shown up for a while.
+class Arena : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Arena(int id, QObject *parent = 0);
+
+    // Set these before the thread starts
+    void setMaxRounds(int maxRounds) { m_maxRounds = maxRounds; }
+    void setMaxPlayers(int maxPlayers) { m_maxPlayers = maxPlayers; }
+    void setInterestRadius(double radius) { m_interestRadius = radius; }
+    void setTickInterval(int tickInterval) { m_tickInterval = tickInterval; }
+    void setRecordingDirectory(const QString &directory) { m_recordingDirectory = directory; }
+
+public slots:
+    // Sets up the game, call this on the arena's thread
+    void start();
+
+    void addConnection(qintptr socketDescriptor);
+
+signals:
+    void statusChanged(int arena, int playerCount, bool running);
+
+    // Full or busy, the Lobby should find another place for it
+    void connectionRejected(qintptr socketDescriptor);
+
+private slots:
+    void onPlayersChanged();
+    void onRoundsPlayedChanged();
+    void startIfReady();
+
+private:
+    int m_id;
+    int m_maxRounds;
+    int m_maxPlayers;
+    double m_interestRadius;
+    int m_tickInterval;
+    QString m_recordingDirectory;
+
+    GameManager *m_manager;
+    QTimer *m_startTimer;
+};
+
+#endif // ARENA_H
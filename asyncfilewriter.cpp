@@ -0,0 +1,89 @@
+#include "asyncfilewriter.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QDebug>
+
+AsyncFileWriter::AsyncFileWriter(QObject *parent) : QThread(parent),
+    m_append(false),
+    m_closing(false)
+{
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    close();
+}
+
+void AsyncFileWriter::open(const QString &fileName, bool append)
+{
+    close();
+
+    m_fileName = fileName;
+    m_append = append;
+    m_closing = false;
+    m_queue.clear();
+
+    start(QThread::LowPriority);
+}
+
+void AsyncFileWriter::write(const QByteArray &data)
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.append(data);
+    m_dataAvailable.wakeOne();
+}
+
+void AsyncFileWriter::close()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_mutex.lock();
+    m_closing = true;
+    m_dataAvailable.wakeOne();
+    m_mutex.unlock();
+
+    wait();
+}
+
+void AsyncFileWriter::run()
+{
+    QFile file(m_fileName);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly;
+    if (m_append) {
+        mode |= QIODevice::Append;
+    }
+
+    if (!file.open(mode)) {
+        qWarning() << "AsyncFileWriter: unable to open" << m_fileName << file.errorString();
+    }
+
+    forever {
+        m_mutex.lock();
+        while (m_queue.isEmpty() && !m_closing) {
+            m_dataAvailable.wait(&m_mutex);
+        }
+
+        // Take everything queued up so far, and write it without holding the lock
+        QList<QByteArray> pending;
+        pending.swap(m_queue);
+        const bool closing = m_closing;
+        m_mutex.unlock();
+
+        // Flushed right away, files can stay open for a long time
+        if (file.isOpen()) {
+            for (const QByteArray &data : pending) {
+                file.write(data);
+            }
+            file.flush();
+        }
+
+        if (closing) {
+            break;
+        }
+    }
+
+    file.close();
+}
@@ -0,0 +1,44 @@
+#ifndef ASYNCFILEWRITER_H
+#define ASYNCFILEWRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QByteArray>
+#include <QString>
+
+// Appends data to a file from a background thread, so callers never block on disk.
+class AsyncFileWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncFileWriter(QObject *parent = 0);
+    ~AsyncFileWriter();
+
+    // Starts the writer thread, truncates the file unless append is set
+    void open(const QString &fileName, bool append = false);
+
+    // Queues data to be written, returns immediately
+    void write(const QByteArray &data);
+
+    // Writes everything still queued, and stops the thread
+    void close();
+
+    bool isOpen() { return isRunning(); }
+
+protected:
+    void run() override;
+
+private:
+    QString m_fileName;
+    bool m_append;
+
+    QMutex m_mutex;
+    QWaitCondition m_dataAvailable;
+    QList<QByteArray> m_queue;
+    bool m_closing;
+};
+
+#endif // ASYNCFILEWRITER_H
@@ -0,0 +1,147 @@
+#ifndef ATLASNODE_H
+#define ATLASNODE_H
+
+#include <QSGGeometryNode>
+#include <QSGTextureMaterial>
+#include <QSGRenderNode>
+#include <QSGRendererInterface>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QPainter>
+#include <QtMath>
+
+#include <functional>
+
+// A batch of textured triangles, all from the same texture.
+// Owns the texture, and keeps the geometry and material as members.
+class AtlasNode : public QSGGeometryNode
+{
+public:
+    AtlasNode() :
+        m_geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 0),
+        m_texture(nullptr)
+    {
+        m_geometry.setDrawingMode(QSGGeometry::DrawTriangles);
+        setGeometry(&m_geometry);
+        setMaterial(&m_material);
+    }
+
+    ~AtlasNode()
+    {
+        delete m_texture;
+    }
+
+    void setTexture(QSGTexture *texture, QSGTexture::Filtering filtering = QSGTexture::Nearest)
+    {
+        delete m_texture;
+        m_texture = texture;
+        m_texture->setFiltering(filtering);
+        m_material.setTexture(m_texture);
+        markDirty(DirtyMaterial);
+    }
+
+    // Room for count quads, fill them in with setQuad() and call markDirty(DirtyGeometry)
+    void allocateQuads(int count)
+    {
+        m_geometry.allocate(count * 6);
+    }
+
+    // The corners go clockwise from the top left, the texture coordinates are for the top left and bottom right
+    void setQuad(int index, const QPointF corners[4], const QRectF &source)
+    {
+        QSGGeometry::TexturedPoint2D *vertices = m_geometry.vertexDataAsTexturedPoint2D() + index * 6;
+        const float left = source.left(), top = source.top(), right = source.right(), bottom = source.bottom();
+        vertices[0].set(corners[0].x(), corners[0].y(), left, top);
+        vertices[1].set(corners[1].x(), corners[1].y(), right, top);
+        vertices[2].set(corners[2].x(), corners[2].y(), right, bottom);
+        vertices[3].set(corners[0].x(), corners[0].y(), left, top);
+        vertices[4].set(corners[2].x(), corners[2].y(), right, bottom);
+        vertices[5].set(corners[3].x(), corners[3].y(), left, bottom);
+    }
+
+    // Same, but with the size of a quad instead of all the corners
+    void setQuad(int index, const QRectF &target, const QRectF &source)
+    {
+        const QPointF corners[4] = { target.topLeft(), target.topRight(), target.bottomRight(), target.bottomLeft() };
+        setQuad(index, corners, source);
+    }
+
+    // The corners of a size x size square at center, rotated clockwise by angle radians
+    static void rotatedSquare(const QPointF &center, qreal size, qreal angle, QPointF corners[4])
+    {
+        const qreal cosine = qCos(angle) * size / 2;
+        const qreal sine = qSin(angle) * size / 2;
+        corners[0] = center + QPointF(-cosine + sine, -sine - cosine);
+        corners[1] = center + QPointF(cosine + sine, sine - cosine);
+        corners[2] = center + QPointF(cosine - sine, sine + cosine);
+        corners[3] = center + QPointF(-cosine - sine, -sine + cosine);
+    }
+
+    // How many of count cells to put side by side, so they make a roughly square texture.
+    // A texture can't be too wide or tall, so with many players one row or column isn't enough.
+    static int gridColumns(int count, const QSize &cellSize)
+    {
+        return qMax(1, qCeil(qSqrt(qreal(count) * cellSize.height() / cellSize.width())));
+    }
+
+private:
+    QSGGeometry m_geometry;
+    QSGTextureMaterial m_material;
+    QSGTexture *m_texture;
+};
+
+// The Qt Quick software backend doesn't draw geometry nodes, so there we
+// paint with QPainter instead. The item gives a function that paints
+// everything, in item coordinates.
+class PainterNode : public QSGRenderNode
+{
+public:
+    explicit PainterNode(QQuickItem *item) : m_item(item) {}
+
+    void setPaint(const std::function<void(QPainter*)> &paint) { m_paint = paint; }
+
+    void render(const RenderState *state) override
+    {
+        QQuickWindow *window = m_item->window();
+        QPainter *painter = static_cast<QPainter*>(window->rendererInterface()->getResource(window, QSGRendererInterface::PainterResource));
+        if (!painter || !m_paint) {
+            return;
+        }
+
+        // The clip has to be set before the transform
+        const QRegion *clipRegion = state->clipRegion();
+        if (clipRegion && !clipRegion->isEmpty()) {
+            painter->setClipRegion(*clipRegion, Qt::ReplaceClip);
+        }
+        painter->setTransform(matrix()->toTransform());
+        painter->setOpacity(inheritedOpacity());
+
+        m_paint(painter);
+    }
+
+    StateFlags changedStates() const override { return 0; }
+    RenderingFlags flags() const override { return BoundedRectRendering; }
+    QRectF rect() const override { return QRectF(0, 0, m_item->width(), m_item->height()); }
+
+    // True when the window uses the software backend, and we need to paint with this
+    static bool isNeeded(QQuickWindow *window)
+    {
+        return window->rendererInterface()->graphicsApi() == QSGRendererInterface::Software;
+    }
+
+    // Draws the source part of image into a size x size square at center, rotated clockwise by angle radians
+    static void drawRotated(QPainter *painter, const QImage &image, const QRect &source, const QPointF &center, qreal size, qreal angle)
+    {
+        const QTransform transform = painter->transform();
+        painter->translate(center);
+        painter->rotate(qRadiansToDegrees(angle));
+        painter->drawImage(QRectF(-size / 2, -size / 2, size, size), image, source);
+        painter->setTransform(transform);
+    }
+
+private:
+    QQuickItem *m_item;
+    std::function<void(QPainter*)> m_paint;
+};
+
+#endif // ATLASNODE_H
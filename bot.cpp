@@ -0,0 +1,125 @@
+#include "bot.h"
+
+namespace {
+
+class IdleBot : public Bot
+{
+public:
+    uint8_t command(const World &, int) override
+    {
+        return CommandNone;
+    }
+};
+
+class RandomBot : public Bot
+{
+public:
+    explicit RandomBot(uint64_t seed) : m_random(seed) {}
+
+    uint8_t command(const World &, int) override
+    {
+        return randomCommand(m_random);
+    }
+
+    // Firing all the time burns through the energy, so mostly move around
+    static uint8_t randomCommand(Pcg32 &random)
+    {
+        const uint32_t roll = random.bounded(100);
+        if (roll < 30) return CommandNone;
+        if (roll < 55) return CommandAccelerate;
+        if (roll < 70) return CommandLeft;
+        if (roll < 85) return CommandRight;
+        if (roll < 93) return CommandMissile;
+        if (roll < 98) return CommandSeeking;
+        return CommandMine;
+    }
+
+private:
+    Pcg32 m_random;
+};
+
+#define ROLLOUT_COUNT 2
+#define ROLLOUT_DEPTH 8
+#define ROLLOUT_DEATH_VALUE -100000.0
+
+class RolloutBot : public Bot
+{
+public:
+    explicit RolloutBot(uint64_t seed) : m_random(seed) {}
+
+    uint8_t command(const World &world, int ship) override
+    {
+        const int shipCount = world.ships().size();
+        m_commands.resize(shipCount);
+
+        uint8_t best = CommandNone;
+        double bestValue = 0;
+        for (int candidate = CommandNone; candidate <= CommandMine; candidate++) {
+            double value = 0;
+            for (int rollout = 0; rollout < ROLLOUT_COUNT; rollout++) {
+                World branch = world;
+                for (int depth = 0; depth < ROLLOUT_DEPTH; depth++) {
+                    for (int i=0; i<shipCount; i++) {
+                        m_commands[i] = RandomBot::randomCommand(m_random);
+                    }
+                    if (depth == 0) {
+                        m_commands[ship] = candidate;
+                    }
+
+                    if (branch.step(m_commands.data())) {
+                        break;
+                    }
+                }
+                value += evaluate(branch, ship);
+            }
+
+            if (candidate == CommandNone || value > bestValue) {
+                best = candidate;
+                bestValue = value;
+            }
+        }
+
+        return best;
+    }
+
+private:
+    // Being alive is all that matters, then having more energy than the others
+    static double evaluate(const World &world, int ship)
+    {
+        const std::vector<ShipState> &ships = world.ships();
+        if (!ships[ship].alive) {
+            return ROLLOUT_DEATH_VALUE;
+        }
+
+        double value = ships[ship].energy;
+        for (size_t i=0; i<ships.size(); i++) {
+            if (int(i) != ship && ships[i].alive) {
+                value -= ships[i].energy / double(ships.size());
+            }
+        }
+        return value;
+    }
+
+    Pcg32 m_random;
+    std::vector<uint8_t> m_commands;
+};
+
+} // namespace
+
+Bot *createBot(const std::string &type, uint64_t seed)
+{
+    if (type == "idle") {
+        return new IdleBot;
+    } else if (type == "random") {
+        return new RandomBot(seed);
+    } else if (type == "rollout") {
+        return new RolloutBot(seed);
+    }
+
+    return nullptr;
+}
+
+std::vector<std::string> botTypes()
+{
+    return { "idle", "random", "rollout" };
+}
@@ -0,0 +1,30 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "world.h"
+
+#include <string>
+#include <vector>
+
+// A bot that runs in the same process as the game, and picks a command by
+// looking straight at the World instead of going through the network.
+class Bot
+{
+public:
+    virtual ~Bot() {}
+
+    // The Command to do this tick, for the ship at index ship
+    virtual uint8_t command(const World &world, int ship) = 0;
+};
+
+// Bump this when the built in bots change, so old cached results don't get used
+#define BUILTIN_BOTS_VERSION 1
+
+// Creates one of the built in bots, or returns nullptr if there is no bot called type.
+//  "idle":    Never does anything
+//  "random":  Random commands, mostly accelerating and turning
+//  "rollout": Tries each command in a few short random look-aheads, and picks the best one
+Bot *createBot(const std::string &type, uint64_t seed);
+std::vector<std::string> botTypes();
+
+#endif // BOT_H
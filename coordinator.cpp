@@ -0,0 +1,260 @@
+#include "coordinator.h"
+
+#include <QDebug>
+#include <QJsonDocument>
+#include <QTcpSocket>
+
+#include <iostream>
+
+Coordinator::Coordinator(const QList<MatchAssignment> &assignments, QObject *parent) : QObject(parent)
+{
+    for (const MatchAssignment &assignment : assignments) {
+        m_assignments.insert(assignment.id, assignment);
+        m_pending.enqueue(assignment.id);
+    }
+
+    m_checkTimer.setInterval(TOURNAMENT_HEARTBEAT_INTERVAL);
+    connect(&m_checkTimer, &QTimer::timeout, this, &Coordinator::checkWorkers);
+    connect(&m_server, &QTcpServer::newConnection, this, &Coordinator::onNewConnection);
+}
+
+bool Coordinator::openCache(const QString &fileName)
+{
+    if (!m_cache.open(fileName)) {
+        return false;
+    }
+
+    int cached = 0;
+    for (const MatchAssignment &assignment : m_assignments) {
+        MatchAssignmentResult result;
+        if (m_cache.lookup(assignment, &result)) {
+            handleResult(result);
+            cached++;
+        }
+    }
+
+    qDebug() << "Coordinator:" << cached << "of" << m_assignments.count() << "matches were already played";
+    return true;
+}
+
+bool Coordinator::listen(quint16 port)
+{
+    if (!m_server.listen(QHostAddress::Any, port)) {
+        qWarning() << "Coordinator: unable to listen on port" << port << m_server.errorString();
+        return false;
+    }
+
+    qDebug() << "Coordinator: waiting for workers on port" << port << "with" << m_assignments.count() << "matches to play";
+    m_checkTimer.start();
+
+    // Everything might be cached already
+    dispatch();
+
+    return true;
+}
+
+void Coordinator::onNewConnection()
+{
+    while (m_server.hasPendingConnections()) {
+        QTcpSocket *socket = m_server.nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, &Coordinator::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &Coordinator::onDisconnected);
+    }
+}
+
+void Coordinator::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    while (socket->canReadLine()) {
+        const QJsonObject message = QJsonDocument::fromJson(socket->readLine()).object();
+        const QString type = message["type"].toString();
+
+        if (type == "hello") {
+            Worker worker;
+            worker.name = socket->peerAddress().toString() + ':' + QString::number(socket->peerPort());
+            worker.slots = qMax(1, message["slots"].toInt(1));
+            worker.lastSeen.start();
+            m_workers.insert(socket, worker);
+            qDebug() << "Coordinator: worker" << worker.name << "joined with" << worker.slots << "slots";
+            dispatch();
+            continue;
+        }
+
+        if (!m_workers.contains(socket)) {
+            qWarning() << "Coordinator: got" << type << "before hello, ignoring";
+            continue;
+        }
+
+        Worker &worker = m_workers[socket];
+        worker.lastSeen.restart();
+
+        if (type == "result") {
+            const MatchAssignmentResult result = MatchAssignmentResult::fromJson(message);
+            worker.assignments.remove(result.id);
+            handleResult(result);
+            dispatch();
+        }
+    }
+}
+
+void Coordinator::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    if (m_workers.contains(socket)) {
+        qWarning() << "Coordinator: worker" << m_workers[socket].name << "disconnected";
+        requeue(socket);
+        m_workers.remove(socket);
+        dispatch();
+    }
+
+    socket->deleteLater();
+}
+
+void Coordinator::checkWorkers()
+{
+    QList<QTcpSocket*> lost;
+    for (auto it = m_workers.begin(); it != m_workers.end(); ++it) {
+        if (it->lastSeen.elapsed() > TOURNAMENT_WORKER_TIMEOUT) {
+            lost.append(it.key());
+        }
+    }
+
+    for (QTcpSocket *socket : lost) {
+        qWarning() << "Coordinator: no heartbeat from worker" << m_workers[socket].name << "giving its matches to someone else";
+        requeue(socket);
+        m_workers.remove(socket);
+        socket->abort();
+    }
+
+    if (!lost.isEmpty()) {
+        dispatch();
+    }
+}
+
+void Coordinator::dispatch()
+{
+    for (auto it = m_workers.begin(); it != m_workers.end() && !m_pending.isEmpty(); ++it) {
+        while (it->assignments.count() < it->slots && !m_pending.isEmpty()) {
+            const int id = m_pending.dequeue();
+            it->assignments.insert(id);
+            m_attempts[id]++;
+            send(it.key(), m_assignments[id].toJson());
+        }
+    }
+
+    if (m_results.count() < m_assignments.count()) {
+        return;
+    }
+
+    for (auto it = m_workers.begin(); it != m_workers.end(); ++it) {
+        QJsonObject done;
+        done["type"] = "done";
+        send(it.key(), done);
+    }
+
+    if (m_checkTimer.isActive()) {
+        printStandings();
+        m_checkTimer.stop();
+        emit finished();
+    }
+}
+
+void Coordinator::requeue(QTcpSocket *socket)
+{
+    for (int id : m_workers[socket].assignments) {
+        if (m_results.contains(id)) {
+            continue;
+        }
+
+        if (m_attempts[id] >= TOURNAMENT_MAX_ATTEMPTS) {
+            MatchAssignmentResult result;
+            result.id = id;
+            result.bots = m_assignments[id].bots;
+            result.error = "Gave up after " + QString::number(m_attempts[id]) + " lost workers";
+            handleResult(result);
+            continue;
+        }
+
+        // Try it again before anything new
+        m_pending.prepend(id);
+    }
+
+    m_workers[socket].assignments.clear();
+}
+
+void Coordinator::handleResult(const MatchAssignmentResult &result)
+{
+    if (!m_assignments.contains(result.id)) {
+        qWarning() << "Coordinator: result for unknown match" << result.id;
+        return;
+    }
+
+    // It might have been given to someone else in the meantime, first one wins
+    if (m_results.contains(result.id)) {
+        return;
+    }
+    m_pending.removeAll(result.id);
+
+    m_results.insert(result.id, result);
+    m_cache.insert(m_assignments[result.id], result);
+    std::cout << QJsonDocument(result.toJson()).toJson(QJsonDocument::Compact).constData() << std::endl;
+
+    qDebug() << "Coordinator:" << m_results.count() << "/" << m_assignments.count() << "matches played";
+}
+
+void Coordinator::send(QTcpSocket *socket, const QJsonObject &object)
+{
+    socket->write(QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void Coordinator::printStandings()
+{
+    struct Standing
+    {
+        int matches = 0;
+        int wins = 0;
+        int score = 0;
+    };
+
+    QMap<QString, Standing> standings;
+    int failed = 0;
+    for (const MatchAssignmentResult &result : m_results) {
+        if (!result.error.isEmpty()) {
+            failed++;
+            continue;
+        }
+
+        for (int i=0; i<result.bots.count() && i<result.wins.count() && i<result.scores.count(); i++) {
+            Standing &standing = standings[result.bots[i]];
+            standing.matches++;
+            standing.wins += result.wins[i];
+            standing.score += result.scores[i];
+        }
+    }
+
+    QStringList bots = standings.keys();
+    std::sort(bots.begin(), bots.end(), [&](const QString &a, const QString &b) {
+        if (standings[a].wins != standings[b].wins) {
+            return standings[a].wins > standings[b].wins;
+        }
+        return standings[a].score > standings[b].score;
+    });
+
+    // The bot goes last, since commands have spaces in them
+    for (const QString &bot : bots) {
+        const Standing &standing = standings[bot];
+        std::cout << standing.wins << ' ' << standing.score << ' ' << standing.matches << ' ' << bot.toStdString() << std::endl;
+    }
+
+    if (failed > 0) {
+        std::cout << failed << " matches failed" << std::endl;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include "tournament.h"
+#include "resultcache.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QQueue>
+#include <QSet>
+#include <QTcpServer>
+#include <QTimer>
+
+class QTcpSocket;
+
+// Hands out the matches of a tournament to the workers that connect, and
+// collects the results. Matches from workers that disconnect or stop
+// sending heartbeats are given to someone else.
+class Coordinator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Coordinator(const QList<MatchAssignment> &assignments, QObject *parent = 0);
+
+    // Matches already in the cache aren't played again, and new results are added to it
+    bool openCache(const QString &fileName);
+
+    bool listen(quint16 port);
+
+signals:
+    void finished();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void checkWorkers();
+
+private:
+    struct Worker
+    {
+        QString name;
+        int slots;
+        QSet<int> assignments;
+        QElapsedTimer lastSeen;
+    };
+
+    void dispatch();
+    void requeue(QTcpSocket *socket);
+    void handleResult(const MatchAssignmentResult &result);
+    void send(QTcpSocket *socket, const QJsonObject &object);
+    void printStandings();
+
+    QTcpServer m_server;
+    QTimer m_checkTimer;
+
+    QMap<int, MatchAssignment> m_assignments;
+    QQueue<int> m_pending;
+    QHash<int, int> m_attempts;
+    QMap<int, MatchAssignmentResult> m_results;
+    QHash<QTcpSocket*, Worker> m_workers;
+
+    ResultCache m_cache;
+};
+
+#endif // COORDINATOR_H
@@ -2,6 +2,8 @@
 
 #include "player.h"
 #include "networkclient.h"
+#include "replayplayer.h"
+#include "playersprites.h"
 
 #include <QDebug>
 #include <QDir>
@@ -17,20 +19,58 @@
 #include <QTimer>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QJsonDocument>
+#include <QDateTime>
 
-#include <cmath>
+#include "world.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
 
 #define VOLUME 0.5f
 
-GameManager::GameManager(QQuickView *view) : QObject(view),
-    m_view(view),
+// Cells along each side of the grids finding what is near each player
+#define INTEREST_GRID_CELLS 32
+
+GameManager::GameManager(QQuickView *view, QObject *parent) :
+    GameManager(view, view ? view->rootContext() : nullptr, view ? view : parent)
+{
+    m_view = view;
+}
+
+GameManager::GameManager(QQuickWindow *window, QQmlContext *context, QObject *parent) : QObject(parent),
+    m_view(nullptr),
+    m_window(window),
     m_roundsPlayed(0),
     m_gameRunning(false),
-    m_maxRounds(MAX_ROUNDS)
+    m_maxRounds(MAX_ROUNDS),
+    m_maxPlayers(DEFAULT_MAX_PLAYERS),
+    m_roundResultsFileName("results.jsonl"),
+    m_printStatus(false),
+    m_replay(nullptr),
+    m_seed(0),
+    m_fixedSeed(false),
+    m_stateDigest(0),
+    m_sendDigest(false),
+    m_tickTimings(),
+    m_frameTime(0),
+    m_manualFrameTime(false),
+    m_interestRadius(0),
+    m_playerGrid(INTEREST_GRID_CELLS),
+    m_missileGrid(INTEREST_GRID_CELLS)
 {
 
     // Add QML objects
-    m_view->rootContext()->setContextProperty("GameManager", QVariant::fromValue(this));
+    if (context) {
+        context->setContextProperty("GameManager", QVariant::fromValue(this));
+    }
+
+    if (m_window) {
+        // Move everything to where it should be in each frame, right before it is drawn
+        connect(m_window, &QQuickWindow::afterAnimating, this, &GameManager::advanceFrame);
+        m_frameClock.start();
+    }
 
     // Set up gametick timer
     m_tickTimer.setInterval(DEFAULT_TICKINTERVAL);
@@ -40,8 +80,6 @@ GameManager::GameManager(QQuickView *view) : QObject(view),
     m_startTimer.setInterval(3000);
     m_startTimer.setSingleShot(true);
 
-    m_server.listen(QHostAddress::Any, 54321);
-
     connect(&m_startTimer, &QTimer::timeout, this, &GameManager::startRound);
     connect(&m_tickTimer, &QTimer::timeout, this, &GameManager::gameTick);
     connect(&m_server, &QTcpServer::newConnection, this, &GameManager::clientConnect);
@@ -57,19 +95,30 @@ GameManager::~GameManager()
     }
 }
 
-QList<QObject*> GameManager::players() const
+QVariantList GameManager::playerColors() const
 {
-    QList<Player*> playerList = m_players;
-
-    // Sort players by wins, and then scores/points
-    std::sort(playerList.begin(), playerList.end(), Player::comparePlayers);
+    return playerColorList(MAX_PLAYERS);
+}
 
-    QList<QObject*> objectList;
-    foreach(Player *playerObject, playerList) {
-        objectList.append(playerObject);
+bool GameManager::listen(quint16 port)
+{
+    if (!m_server.listen(QHostAddress::Any, port)) {
+        qWarning() << "GameManager: unable to listen on port" << port << m_server.errorString();
+        return false;
     }
 
-    return objectList;
+    qDebug() << "GameManager: listening on port" << port;
+    printStatus("LISTENING " + QByteArray::number(port));
+    return true;
+}
+
+QStringList GameManager::playerNames() const
+{
+    QStringList names;
+    for (Player *player : m_players) {
+        names.append(player->name());
+    }
+    return names;
 }
 
 QString GameManager::version()
@@ -86,6 +135,10 @@ QString GameManager::version()
 
 void GameManager::endRound()
 {
+    if (m_replay) {
+        return;
+    }
+
     m_tickTimer.stop();
 
     emit roundOver();
@@ -94,6 +147,7 @@ void GameManager::endRound()
         m_missiles[i]->deleteLater();
     }
     m_missiles.clear();
+    m_world.clearMissiles();
 
     for (int i=0; i<m_players.count(); i++) {
         if (!m_players[i]->networkClient()) continue;
@@ -106,6 +160,8 @@ void GameManager::endRound()
         }
     }
 
+    writeRoundResults();
+
     m_roundsPlayed++;
     emit roundsPlayedChanged();
 
@@ -116,20 +172,8 @@ void GameManager::endRound()
         }
         m_startTimer.start();
     } else {
-        QFile scoreFile("scores.txt");
-        if (!scoreFile.open(QIODevice::WriteOnly)) {
-            return;
-        }
-
-        QList<Player*> playerList = m_players;
-        std::sort(playerList.begin(), playerList.end(), Player::comparePlayers);
-
-        for(Player *player : playerList) {
-            scoreFile.write(player->name().toUtf8() + ' ' +
-                            QByteArray::number(player->wins()) + ' ' +
-                            QByteArray::number(player->score()) + ' ' +
-                            QByteArray::number(player->energy()) + '\n');
-        }
+        m_recorder.finish();
+        writeResults();
     }
 }
 
@@ -143,13 +187,19 @@ void GameManager::startRound()
         return;
     }
 
-    resetPositions();
+    m_world.setShipCount(m_players.count());
+    m_world.startRound();
+    m_roundStatistics.start(m_world);
 
     for (int i=0; i<m_players.count(); i++) {
         m_players[i]->setCommand(QString());
-        m_players[i]->setAlive(true);
-        m_players[i]->setEnergy(START_ENERGY);
+
+        // Late answers to the last round aren't part of this one
+        if (m_players[i]->networkClient()) {
+            m_players[i]->networkClient()->takeLatencies();
+        }
     }
+    syncFromWorld();
 
     // Do not allow to change name after game has started
     for (int i=0; i<m_players.count(); i++) {
@@ -165,7 +215,7 @@ void GameManager::startRound()
 
 void GameManager::startGame()
 {
-    if (m_gameRunning) {
+    if (m_gameRunning || m_replay) {
         return;
     }
 
@@ -178,13 +228,32 @@ void GameManager::startGame()
         m_missiles[i]->deleteLater();
     }
     m_missiles.clear();
+    m_world.clearMissiles();
 
     m_roundsPlayed = 0;
     emit roundsPlayedChanged();
 
+    if (!m_fixedSeed) {
+        std::random_device randomDevice;
+        m_seed = (quint64(randomDevice()) << 32) | randomDevice();
+    }
+    m_world.setSeed(m_seed);
+    qDebug() << "Starting game with seed" << m_seed;
+
     m_gameRunning = true;
     emit gameRunningChanged();
 
+    if (!m_recordingDirectory.isEmpty()) {
+        QDir().mkpath(m_recordingDirectory);
+        const QString fileName = QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz") + ".tomr";
+        m_recorder.start(QDir(m_recordingDirectory).filePath(fileName), m_seed, m_tickTimer.interval(), m_players);
+    }
+
+    // Stays open until we're gone, so the GUI never waits for it to finish writing
+    if (!m_roundResultsFileName.isEmpty() && !m_roundResultsWriter.isOpen()) {
+        m_roundResultsWriter.open(m_roundResultsFileName, true);
+    }
+
     if (m_startTimer.interval() > 0) {
         emit showCountdown();
     }
@@ -194,122 +263,54 @@ void GameManager::startGame()
 
 void GameManager::gameTick()
 {
-    QMutableListIterator<Missile*> missileIterator(m_missiles);
-    while (missileIterator.hasNext()) {
-        Missile *missile = missileIterator.next();
-
-        missile->doMove();
-
-        if (!missile->isAlive()) {
-            missile->deleteLater();
-            missileIterator.remove();
+    std::vector<uint8_t> commands(m_players.count(), CommandNone);
+    for (int i=0; i<m_players.count(); i++) {
+        if (!m_players[i]->isAlive()) {
+            // Disconnected players stay dead
+            m_world.ship(i).alive = false;
             continue;
         }
 
-        Player *closest = nullptr;
-        qreal closestDX;
-        qreal closestDY;
-        for(int i=0; i<m_players.count(); i++) {
-            if (!m_players[i]->isAlive()) {
-                continue;
-            }
-
-            if (missile->owner() == m_players[i]->id()) {
-                continue;
-            }
-
-            const qreal dx = m_players[i]->position().x() - missile->position().x();
-            const qreal dy = m_players[i]->position().y() - missile->position().y();
-            if (hypot(dx, dy) < 0.1) {
-                m_players[i]->decreaseEnergy(MISSILE_DAMAGE);
-                m_players[missile->owner()]->increaseEnergy(MISSILE_DAMAGE);
-                m_players[missile->owner()]->addScore(1);
-                emit explosion(missile->position());
-                missile->deleteLater();
-                missileIterator.remove();
-                break;
-            }
-
-            // For seeking missiles
-            if (!closest || hypot(dx, dy) < hypot(closestDX, closestDY)) {
-                closest = m_players[i];
-                closestDX = dx;
-                closestDY = dy;
-                continue;
-            }
-        }
-
-        if (missile->type() == Missile::Seeking && closest) {
-            missile->setRotation(atan2(closestDY, closestDX));
-        }
+        commands[i] = commandFromName(m_players[i]->command().toLatin1().constData());
     }
 
+    QElapsedTimer phaseTimer;
+    phaseTimer.start();
 
-    // Randomize the order we process players in
-    QList<Player*> players = m_players;
-    for (int index = players.count() - 1; index > 0; --index) {
-        qSwap(players[index], players[qrand() % (index + 1)]);
-    }
+    const bool roundOver = m_world.step(commands.data());
+    m_tickTimings.stepNanoseconds += phaseTimer.nsecsElapsed();
+    m_tickTimings.ticks++;
 
-    int dead = 0;
-    foreach(Player *player, players) {
-        if (!player->isAlive()) {
-            dead++;
-            continue;
-        }
+    phaseTimer.restart();
+    syncFromWorld();
+    m_roundStatistics.addTick(m_world);
 
-        player->doMove();
-        player->decreaseEnergy(1);
-
-        QString command = player->command();
-        if (command.isEmpty()) {
-            continue;
-        }
-
-        if (command == "ACCELERATE") {
-            player->accelerate();
-        } else if (command == "LEFT") {
-            player->rotate(-ROTATE_AMOUNT);
-        } else if (command == "RIGHT") {
-            player->rotate(ROTATE_AMOUNT);
-        } else if (command == "MISSILE") {
-            player->decreaseEnergy(MISSILE_COST);
-            Missile *missile = new Missile(Missile::Normal, player->position(), player->rotation(), player->id(), this);
-            m_missiles.append(missile);
-            emit missileCreated(missile);
-        } else if (command == "SEEKING") {
-            player->decreaseEnergy(SEEKING_MISSILE_COST);
-            Missile *missile = new Missile(Missile::Seeking, player->position(), player->rotation(), player->id(), this);
-            m_missiles.append(missile);
-            emit missileCreated(missile);
-        } else if (command == "MINE") {
-            player->decreaseEnergy(MINE_COST);
-            Missile *missile = new Missile(Missile::Mine, player->position(), player->rotation(), player->id(), this);
-            m_missiles.append(missile);
-            emit missileCreated(missile);
-        }
+    for (const Hit &hit : m_world.hits()) {
+        m_players[hit.owner]->addScore(1);
+        emit explosion(QPointF(hit.x, hit.y));
     }
 
-    if (dead > 0 && players.size() - dead < 2) {
+    m_stateDigest = m_world.digest();
+    m_recorder.recordTick(m_roundsPlayed, m_world, m_stateDigest);
+    m_tickTimings.syncNanoseconds += phaseTimer.nsecsElapsed();
+
+    if (roundOver) {
         endRound();
         return;
     }
 
-    // Send status updates to all connected players
-    foreach(Player *player, players) {
-        if (!player->networkClient()) {
-            continue;
-        }
+    phaseTimer.restart();
 
-        player->networkClient()->sendState(serializeForPlayer(player));
-    }
+    sendStates();
+
+    m_tickTimings.sendNanoseconds += phaseTimer.nsecsElapsed();
 }
 
 void GameManager::clientConnect()
 {
     QTcpSocket *socket = m_server.nextPendingConnection();
 
-    if (m_players.count() >= MAX_PLAYERS || m_tickTimer.isActive()) {
+    if (m_players.count() >= m_maxPlayers || m_tickTimer.isActive() || m_replay) {
         socket->disconnect();
         socket->deleteLater();
         return;
@@ -336,7 +337,9 @@ void GameManager::clientDisconnected()
         return;
     }
 
+    m_scoreboard.removePlayer(playerObject);
     m_players.takeAt(index)->deleteLater();
+    m_world.removeShip(index);
     for (int i=0; i<m_players.count(); i++) {
         m_players[i]->setId(i);
     }
@@ -346,13 +349,19 @@ void GameManager::clientDisconnected()
 
 void GameManager::addPlayer(NetworkClient *client)
 {
-    if (m_players.count() >= MAX_PLAYERS) {
+    if (m_players.count() >= m_maxPlayers) {
+        return;
+    }
+
+    if (!client && !m_view) {
+        qWarning() << "GameManager: can't add a local player without a view";
         return;
     }
 
     Player *player = new Player(this, m_players.count(), client);
 
     m_players.append(player);
+    m_scoreboard.addPlayer(player);
 
     resetPositions();
 
@@ -362,6 +371,8 @@ void GameManager::addPlayer(NetworkClient *client)
     } else {
         player->setName(client->remoteName());
         connect(player, &Player::clientDisconnected, this, &GameManager::clientDisconnected);
+        qDebug() << "GameManager: player" << player->id() << "connected from" << client->remoteName();
+        printStatus("CONNECTED " + QByteArray::number(player->id()));
     }
 
     emit playersChanged();
@@ -376,7 +387,9 @@ void GameManager::kick(int index)
     if (m_players.at(index)->networkClient()) {
         m_players.at(index)->networkClient()->kick();
     } else {
+        m_scoreboard.removePlayer(m_players.at(index));
         m_players.takeAt(index)->deleteLater();
+        m_world.removeShip(index);
     }
 
     for (int i=0; i<m_players.count(); i++) {
@@ -403,6 +416,11 @@ void GameManager::setTickInterval(int interval)
 
 void GameManager::togglePause()
 {
+    if (m_replay) {
+        m_replay->togglePlaying();
+        return;
+    }
+
     if (m_tickTimer.isActive()) {
         m_tickTimer.stop();
     } else {
@@ -412,17 +430,21 @@ void GameManager::togglePause()
 
 void GameManager::stopGame()
 {
+    if (m_replay) {
+        return;
+    }
+
     m_startTimer.stop(); // Just in case
     m_tickTimer.stop();
+    m_recorder.finish();
     m_gameRunning = false;
     emit gameRunningChanged();
 
-    QMutableListIterator<Player*> it(m_players);
-    while(it.hasNext()) {
-        Player *player = it.next();
-        if (player->isDisconnected()) {
-            player->deleteLater();
-            it.remove();
+    for (int i=m_players.count() - 1; i>=0; i--) {
+        if (m_players[i]->isDisconnected()) {
+            m_scoreboard.removePlayer(m_players.at(i));
+            m_players.takeAt(i)->deleteLater();
+            m_world.removeShip(i);
         }
     }
 
@@ -435,36 +457,380 @@ void GameManager::stopGame()
 
 void GameManager::resetPositions()
 {
-    int playerCount = m_players.count();
-    for (int i=0; i<playerCount; i++) {
-        qreal angle = i * M_PI * 2.0 / playerCount;
-        m_players[i]->setPosition(QPointF(cos(angle) * 0.5, sin(angle) * 0.5));
+    m_world.setShipCount(m_players.count());
+    m_world.placeShips();
+    syncFromWorld();
+}
+
+void GameManager::sendStates()
+{
+    // Everyone gets the same players and missiles, so only turn them into JSON once
+    QVector<QJsonObject> playerObjects(m_players.count());
+    QVector<int> aliveIndexes(m_players.count(), -1);
+    QJsonArray aliveArray;
+    for (int i=0; i<m_players.count(); i++) {
+        playerObjects[i] = m_players[i]->serialize();
+        if (m_players[i]->isAlive()) {
+            aliveIndexes[i] = aliveArray.count();
+            aliveArray.append(playerObjects[i]);
+        }
+    }
+
+    QVector<QJsonObject> missileObjects;
+    missileObjects.reserve(m_missiles.count());
+    QJsonArray missilesArray;
+    foreach (Missile *missile, m_missiles) {
+        missileObjects.append(missile->serialize());
+        missilesArray.append(missileObjects.last());
+    }
+
+    // Only filled when someone wants just what's near them
+    bool gridsFilled = false;
+
+    for (int i=0; i<m_players.count(); i++) {
+        NetworkClient *client = m_players[i]->networkClient();
+        if (!client) {
+            continue;
+        }
+
+        const double radius = client->interestRadius() >= 0 ? client->interestRadius() : m_interestRadius;
+        if (radius <= 0 && client->interestLimit() <= 0) {
+            client->sendState(serializeForPlayer(playerObjects[i], aliveIndexes[i], aliveArray, missilesArray));
+            continue;
+        }
+
+        if (!gridsFilled) {
+            fillGrids();
+            gridsFilled = true;
+        }
+
+        client->sendState(serializeNearPlayer(i, radius, client->interestLimit(), playerObjects, missileObjects, aliveArray.count()));
+    }
+}
+
+void GameManager::fillGrids()
+{
+    const std::vector<ShipState> &ships = m_world.ships();
+    m_playerGrid.clear();
+    for (int i=0; i<qMin<int>(m_players.count(), ships.size()); i++) {
+        if (m_players[i]->isAlive()) {
+            m_playerGrid.insert(i, ships[i].x, ships[i].y);
+        }
+    }
+
+    // Same order as m_missiles, syncFromWorld keeps them in step
+    const std::vector<MissileState> &missiles = m_world.missiles();
+    m_missileGrid.clear();
+    for (int i=0; i<qMin<int>(m_missiles.count(), missiles.size()); i++) {
+        m_missileGrid.insert(i, missiles[i].x, missiles[i].y);
     }
 }
 
-QJsonObject GameManager::serializeForPlayer(Player *player)
+QJsonObject GameManager::serializeNearPlayer(int index, double radius, int limit, const QVector<QJsonObject> &players, const QVector<QJsonObject> &missiles, int aliveCount)
 {
+    // Nothing is further away than this, the area wraps around
+    if (radius <= 0) {
+        radius = 2;
+    }
+
+    const ShipState &ship = m_world.ships()[index];
+
     QJsonObject gamestateObject;
-    gamestateObject["you"] = player->serialize();
+    gamestateObject["you"] = players[index];
+
+    // Ask for one more, we find ourselves too
+    m_nearby.clear();
+    if (limit > 0) {
+        m_playerGrid.nearest(ship.x, ship.y, radius, limit + 1, &m_nearby);
+    } else {
+        m_playerGrid.query(ship.x, ship.y, radius, &m_nearby);
+        std::sort(m_nearby.begin(), m_nearby.end());
+    }
 
     QJsonArray playersArray;
-    foreach (Player *otherPlayer, m_players) {
-        if (otherPlayer == player) {
+    for (int other : m_nearby) {
+        if (other == index) {
             continue;
         }
-        if (!otherPlayer->isAlive()) {
-            continue;
+        if (limit > 0 && playersArray.count() >= limit) {
+            break;
         }
-
-        playersArray.append(otherPlayer->serialize());
+        playersArray.append(players[other]);
     }
     gamestateObject["others"] = playersArray;
 
+    m_nearby.clear();
+    if (limit > 0) {
+        m_missileGrid.nearest(ship.x, ship.y, radius, limit, &m_nearby);
+    } else {
+        m_missileGrid.query(ship.x, ship.y, radius, &m_nearby);
+        std::sort(m_nearby.begin(), m_nearby.end());
+    }
+
     QJsonArray missilesArray;
-    foreach (Missile *missile, m_missiles) {
-        missilesArray.append(missile->serialize());
+    for (int missile : m_nearby) {
+        missilesArray.append(missiles[missile]);
     }
     gamestateObject["missiles"] = missilesArray;
 
+    // So they at least know how much is going on elsewhere
+    QJsonObject outsideObject;
+    outsideObject["players"] = aliveCount - (m_players[index]->isAlive() ? 1 : 0) - playersArray.count();
+    outsideObject["missiles"] = missiles.count() - missilesArray.count();
+    gamestateObject["outside"] = outsideObject;
+
+    if (m_sendDigest) {
+        gamestateObject["digest"] = QString("%1").arg(m_stateDigest, 16, 16, QChar('0'));
+    }
+
     return gamestateObject;
 }
+
+QJsonObject GameManager::serializeForPlayer(const QJsonObject &player, int aliveIndex, const QJsonArray &alivePlayers, const QJsonArray &missiles)
+{
+    QJsonObject gamestateObject;
+    gamestateObject["you"] = player;
+
+    // Everyone alive except the player itself
+    QJsonArray playersArray = alivePlayers;
+    if (aliveIndex >= 0) {
+        playersArray.removeAt(aliveIndex);
+    }
+    gamestateObject["others"] = playersArray;
+
+    gamestateObject["missiles"] = missiles;
+
+    if (m_sendDigest) {
+        gamestateObject["digest"] = QString("%1").arg(m_stateDigest, 16, 16, QChar('0'));
+    }
+
+    return gamestateObject;
+}
+
+bool GameManager::loadReplay(const QString &fileName)
+{
+    ReplayPlayer *replay = new ReplayPlayer(this);
+    if (!replay->open(fileName)) {
+        qWarning() << "GameManager: unable to open replay" << fileName << replay->errorString();
+        delete replay;
+        return false;
+    }
+
+    m_server.close();
+    m_startTimer.stop();
+    m_tickTimer.stop();
+
+    qDeleteAll(m_missiles);
+    m_missiles.clear();
+    m_scoreboard.clear();
+    qDeleteAll(m_players);
+    m_players.clear();
+
+    for (const QString &name : replay->playerNames()) {
+        Player *player = new Player(this, m_players.count());
+        player->setName(name);
+        m_players.append(player);
+        m_scoreboard.addPlayer(player);
+    }
+    m_world.setShipCount(m_players.count());
+
+    m_replay = replay;
+    connect(m_replay, &ReplayPlayer::frameChanged, this, &GameManager::showReplayFrame);
+
+    m_maxRounds = m_replay->roundCount();
+    m_gameRunning = true;
+
+    emit replayChanged();
+    emit gameRunningChanged();
+    emit playersChanged();
+
+    showReplayFrame();
+    m_replay->play();
+
+    return true;
+}
+
+QObject *GameManager::replay()
+{
+    return m_replay;
+}
+
+void GameManager::showReplayFrame()
+{
+    const ReplayFrame &frame = m_replay->currentFrame();
+    if (!frame.header) {
+        return;
+    }
+
+    if (m_roundsPlayed != frame.header->round) {
+        m_roundsPlayed = frame.header->round;
+        emit roundsPlayedChanged();
+    }
+
+    std::vector<ShipState> ships(frame.header->playerCount);
+    for (quint32 i=0; i<frame.header->playerCount; i++) {
+        const PlayerRecord &record = frame.players[i];
+        ShipState &ship = ships[i];
+        ship.x = record.x;
+        ship.y = record.y;
+        ship.velocityX = record.velocityX;
+        ship.velocityY = record.velocityY;
+        ship.rotation = record.rotation;
+        ship.energy = record.energy;
+        ship.alive = record.alive;
+
+        if (int(i) < m_players.count()) {
+            m_players[i]->setLastCommand(commandName(record.command));
+        }
+    }
+
+    std::vector<MissileState> missiles(frame.header->missileCount);
+    for (quint32 i=0; i<frame.header->missileCount; i++) {
+        const MissileRecord &record = frame.missiles[i];
+        MissileState &missile = missiles[i];
+        missile.id = record.id;
+        missile.type = record.type;
+        missile.owner = record.owner;
+        missile.target = -1;
+        missile.x = record.x;
+        missile.y = record.y;
+        missile.velocityX = record.velocityX;
+        missile.velocityY = record.velocityY;
+        missile.rotation = record.rotation;
+        missile.energy = record.energy;
+        missile.alive = true;
+    }
+
+    m_world.setState(ships, missiles);
+    syncFromWorld();
+}
+
+void GameManager::writeResults()
+{
+    if (m_resultsFileName.isEmpty()) {
+        return;
+    }
+
+    QJsonArray playersArray;
+    for (Player *player : m_players) {
+        QJsonObject playerObject;
+        playerObject["id"] = player->id();
+        playerObject["name"] = player->name();
+        playerObject["wins"] = player->wins();
+        playerObject["score"] = player->score();
+        playerObject["energy"] = player->energy();
+        playersArray.append(playerObject);
+    }
+
+    QJsonObject resultsObject;
+    resultsObject["seed"] = QString::number(m_seed); // Doesn't fit in a double
+    resultsObject["rounds"] = m_roundsPlayed;
+    resultsObject["players"] = playersArray;
+
+    QFile resultsFile(m_resultsFileName);
+    if (!resultsFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "GameManager: unable to write results to" << m_resultsFileName << resultsFile.errorString();
+        return;
+    }
+    resultsFile.write(QJsonDocument(resultsObject).toJson());
+}
+
+void GameManager::writeRoundResults()
+{
+    if (!m_roundResultsWriter.isOpen()) {
+        return;
+    }
+
+    for (int i=0; i<m_players.count(); i++) {
+        if (m_players[i]->networkClient()) {
+            m_roundStatistics.addLatencies(i, m_players[i]->networkClient()->takeLatencies());
+        }
+    }
+
+    const QJsonObject record = m_roundStatistics.toJson(m_roundsPlayed, m_seed, m_players);
+    m_roundResultsWriter.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void GameManager::printStatus(const QByteArray &status)
+{
+    if (!m_printStatus) {
+        return;
+    }
+
+    const QByteArray line = "STATUS " + status + '\n';
+    fwrite(line.constData(), 1, line.size(), stdout);
+    fflush(stdout);
+}
+
+void GameManager::syncFromWorld()
+{
+    const std::vector<ShipState> &ships = m_world.ships();
+    const int playerCount = qMin<int>(m_players.count(), ships.size());
+    for (int i=0; i<playerCount; i++) {
+        const ShipState &ship = ships[i];
+        if (m_players[i]->isAlive() && !ship.alive) {
+            emit playerDied(QPointF(ship.x, ship.y));
+        }
+        m_players[i]->setState(QPointF(ship.x, ship.y), ship.velocityX, ship.velocityY, ship.rotation, ship.energy, ship.alive);
+    }
+
+    // Both the world's missiles and ours are sorted by id, so just walk through them both
+    const std::vector<MissileState> &worldMissiles = m_world.missiles();
+    QList<Missile*> missiles;
+    QList<Missile*> createdMissiles;
+    int existing = 0;
+    for (const MissileState &state : worldMissiles) {
+        while (existing < m_missiles.count() && m_missiles[existing]->id() < state.id) {
+            m_missiles[existing++]->deleteLater();
+        }
+
+        Missile *missile;
+        if (existing < m_missiles.count() && m_missiles[existing]->id() == state.id) {
+            missile = m_missiles[existing++];
+        } else {
+            missile = new Missile(Missile::Type(state.type), state.owner, state.id, this);
+            createdMissiles.append(missile);
+        }
+
+        missile->setState(QPointF(state.x, state.y), state.velocityX, state.velocityY, state.rotation, state.energy);
+        missiles.append(missile);
+    }
+
+    while (existing < m_missiles.count()) {
+        m_missiles[existing++]->deleteLater();
+    }
+
+    m_missiles = missiles;
+
+    for (Missile *missile : createdMissiles) {
+        emit missileCreated(missile);
+    }
+
+    if (m_window) {
+        m_interpolator.addSnapshot(m_world, frameTime());
+        m_window->update();
+    }
+}
+
+void GameManager::advanceFrame()
+{
+    m_interpolator.update(frameTime());
+
+    const std::vector<ShipState> &ships = m_interpolator.ships();
+    const int playerCount = qMin<int>(m_players.count(), ships.size());
+    for (int i=0; i<playerCount; i++) {
+        m_players[i]->setDisplayPosition(QPointF(ships[i].x, ships[i].y));
+    }
+
+    emit frameAdvanced();
+
+    // Keep the frames coming until we have caught up with the game
+    if (!m_interpolator.isSettled()) {
+        m_window->update();
+    }
+}
+
+qint64 GameManager::frameTime() const
+{
+    return m_manualFrameTime ? m_frameTime : m_frameClock.elapsed();
+}
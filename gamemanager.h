@@ -5,16 +5,40 @@
 #include <QPointer>
 #include <QList>
 #include <QString>
+#include <QStringList>
+#include <QVariantList>
 #include <QTimer>
 #include <QTcpServer>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QVector>
 
 #include "missile.h"
 #include "player.h"
 #include "parameters.h"
+#include "matchrecorder.h"
+#include "asyncfilewriter.h"
+#include "roundstatistics.h"
+#include "world.h"
+#include "interpolator.h"
+#include "scoreboard.h"
+#include "spatialgrid.h"
 
 class QQuickView;
+class QQuickWindow;
+class QQmlContext;
 class QQmlComponent;
 class NetworkClient;
+class ReplayPlayer;
+
+// Time spent in each part of the ticks, since the game manager was created
+struct TickTimings
+{
+    quint64 ticks;
+    qint64 stepNanoseconds; // Running the rules
+    qint64 syncNanoseconds; // Mirroring into the Player and Missile objects, and recording
+    qint64 sendNanoseconds; // Sending the state to the clients
+};
 
 class GameManager : public QObject
 {
@@ -22,14 +46,23 @@ class GameManager : public QObject
 
     Q_PROPERTY(bool gameRunning READ isGameRunning NOTIFY gameRunningChanged)
     Q_PROPERTY(int roundsPlayed READ roundsPlayed() NOTIFY roundsPlayedChanged())
-    Q_PROPERTY(QList<QObject*> players READ players NOTIFY playersChanged)
+    Q_PROPERTY(QObject *scoreboard READ scoreboard CONSTANT)
     Q_PROPERTY(int maxPlayers READ maxPlayerCount CONSTANT)
+    Q_PROPERTY(QVariantList playerColors READ playerColors CONSTANT)
     Q_PROPERTY(int maxRounds READ maxRounds CONSTANT)
+    Q_PROPERTY(QObject *replay READ replay NOTIFY replayChanged)
 
 public:
-    explicit GameManager(QQuickView *parent);
+    // Without a view there is nothing to show, and no local player
+    explicit GameManager(QQuickView *view = nullptr, QObject *parent = nullptr);
+
+    // Shows the game in a window that isn't a QQuickView, like an offscreen one. There's no local player then.
+    GameManager(QQuickWindow *window, QQmlContext *context, QObject *parent = nullptr);
     ~GameManager();
 
+    // Start accepting clients
+    bool listen(quint16 port = DEFAULT_PORT);
+
     Q_INVOKABLE void removeHumanPlayer();
 
     Q_INVOKABLE void setTickInterval(int interval);
@@ -40,14 +73,66 @@ public:
 
     bool isGameRunning() const { return m_gameRunning; }
 
-    QList<QObject *> players() const;
+    // A game is being played or watched, with rounds left, so the screen shouldn't go idle
+    bool isRoundActive() const { return m_replay || (m_gameRunning && m_roundsPlayed < m_maxRounds); }
+
+    // The players in order of wins and score
+    QObject *scoreboard() { return &m_scoreboard; }
+    int playerCount() const { return m_players.count(); }
 
-    int maxPlayerCount() { return MAX_PLAYERS; }
+    int maxPlayerCount() { return m_maxPlayers; }
+    void setMaxPlayers(int maxPlayers) { m_maxPlayers = qBound(1, maxPlayers, MAX_PLAYERS); }
+
+    // One for every possible player, the first ones are the classic red, blue, green and yellow
+    QVariantList playerColors() const;
     int maxRounds() { return m_maxRounds; }
     void setMaxRounds(int maxRounds) { m_maxRounds = maxRounds; }
 
     void setCountdownDuration(int duration) { m_startTimer.setInterval(duration); }
 
+    // Use the same seed for every game, instead of a new random one for each
+    void setSeed(quint64 seed) { m_seed = seed; m_fixedSeed = true; }
+    quint64 seed() { return m_seed; }
+
+    // Where to draw the missiles in the current frame, updated before frameAdvanced() is emitted
+    const std::vector<MissileState> &displayedMissiles() const { return m_interpolator.missiles(); }
+    const std::vector<ShipState> &displayedShips() const { return m_interpolator.ships(); }
+
+    // In the order they connected
+    QStringList playerNames() const;
+    const QList<Player*> &playerList() const { return m_players; }
+
+    const TickTimings &tickTimings() const { return m_tickTimings; }
+
+    // Moves things between ticks by this time instead of the real one from now on, for rendering faster than real time
+    void setFrameTime(qint64 milliseconds) { m_frameTime = milliseconds; m_manualFrameTime = true; }
+
+    // Hash of the state of all players and missiles, updated after every tick
+    quint64 stateDigest() { return m_stateDigest; }
+    void setSendDigest(bool sendDigest) { m_sendDigest = sendDigest; }
+
+    // Only send each client the players and missiles within radius of it, instead of all of them.
+    // 0 sends everything. Clients can ask for something else themselves, with INTEREST.
+    void setInterestRadius(double radius) { m_interestRadius = radius; }
+
+    // Where a JSON record of every round gets appended, one per line, empty to disable
+    void setRoundResultsFileName(const QString &fileName) { m_roundResultsFileName = fileName; }
+
+    // Also write the final scores as JSON, with the players in the order they connected
+    void setResultsFileName(const QString &fileName) { m_resultsFileName = fileName; }
+
+    // Print STATUS lines to stdout as the game gets ready, for whatever started it:
+    // "STATUS LISTENING <port>" and "STATUS CONNECTED <player id>". They don't go
+    // through the log, so log levels and a full log buffer can't hide them.
+    void setPrintStatus(bool printStatus) { m_printStatus = printStatus; }
+
+    // Record every match played into this directory, empty to disable
+    void setRecordingDirectory(const QString &directory) { m_recordingDirectory = directory; }
+
+    // Shows a recorded match instead of playing, no clients are accepted after this
+    bool loadReplay(const QString &fileName);
+    QObject *replay();
+
 public slots:
     void endRound();
     void startRound();
@@ -59,6 +144,9 @@ public slots:
 
     int roundsPlayed() { return m_roundsPlayed; }
 
+    // Moves everything to where it should be shown in this frame, done right before each frame is drawn
+    void advanceFrame();
+
 signals:
     void gameRunningChanged();
     void roundOver();
@@ -66,19 +154,37 @@ signals:
     void roundsPlayedChanged();
     void playersChanged();
     void explosion(QPointF position);
+    void playerDied(QPointF position);
     void missileCreated(QObject *missile);
     void showCountdown();
+    void replayChanged();
+    void frameAdvanced();
 
 private slots:
     void gameTick();
     void clientConnect();
     void clientDisconnected();
+    void showReplayFrame();
 
 private:
     void resetPositions();
-    QJsonObject serializeForPlayer(Player *player);
+    // The state as one player sees it, put together from the JSON made once per tick.
+    // aliveIndex is where the player is in alivePlayers, or -1 when it is dead.
+    QJsonObject serializeForPlayer(const QJsonObject &player, int aliveIndex, const QJsonArray &alivePlayers, const QJsonArray &missiles);
+
+    // The same, but with only what's near the player, and how much more there is elsewhere
+    QJsonObject serializeNearPlayer(int index, double radius, int limit, const QVector<QJsonObject> &players, const QVector<QJsonObject> &missiles, int aliveCount);
+
+    void sendStates();
+    void fillGrids();
+    void syncFromWorld();
+    void writeResults();
+    void writeRoundResults();
+    void printStatus(const QByteArray &status);
+    qint64 frameTime() const;
 
     QQuickView *m_view;
+    QQuickWindow *m_window;
     QList<Player*> m_players;
     QList<Missile*> m_missiles;
     QTimer m_tickTimer;
@@ -87,6 +193,32 @@ private:
     bool m_gameRunning;
     QTimer m_startTimer;
     int m_maxRounds;
+    int m_maxPlayers;
+    QString m_roundResultsFileName;
+    AsyncFileWriter m_roundResultsWriter;
+    RoundStatistics m_roundStatistics;
+    QString m_resultsFileName;
+    QString m_recordingDirectory;
+    bool m_printStatus;
+    MatchRecorder m_recorder;
+    ReplayPlayer *m_replay;
+    quint64 m_seed;
+    bool m_fixedSeed;
+    World m_world;
+    quint64 m_stateDigest;
+    bool m_sendDigest;
+    Interpolator m_interpolator;
+    Scoreboard m_scoreboard;
+    TickTimings m_tickTimings;
+    QElapsedTimer m_frameClock;
+    qint64 m_frameTime;
+    bool m_manualFrameTime;
+
+    // For finding what is near each player when sending the state
+    double m_interestRadius;
+    SpatialGrid m_playerGrid;
+    SpatialGrid m_missileGrid;
+    std::vector<int> m_nearby;
 };
 
 #endif // GAMEMANAGER_H
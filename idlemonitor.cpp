@@ -0,0 +1,70 @@
+#include "idlemonitor.h"
+
+#include "gamemanager.h"
+
+#include <QEvent>
+#include <QQuickWindow>
+
+#define IDLE_DEFAULT_TIMEOUT 30000
+
+IdleMonitor::IdleMonitor(GameManager *manager, QQuickWindow *window) : QObject(window),
+    m_manager(manager),
+    m_idle(false)
+{
+    m_idleTimer.setInterval(IDLE_DEFAULT_TIMEOUT);
+    m_idleTimer.setSingleShot(true);
+    connect(&m_idleTimer, &QTimer::timeout, this, &IdleMonitor::onTimeout);
+
+    // The countdown has to be drawn smoothly, so don't wait for anything else
+    connect(manager, &GameManager::showCountdown, this, &IdleMonitor::wake);
+    connect(manager, &GameManager::gameRunningChanged, this, &IdleMonitor::wake);
+    connect(manager, &GameManager::roundsPlayedChanged, this, &IdleMonitor::wake);
+    connect(manager, &GameManager::replayChanged, this, &IdleMonitor::wake);
+
+    window->installEventFilter(this);
+
+    m_idleTimer.start();
+}
+
+void IdleMonitor::wake()
+{
+    setIdle(false);
+    m_idleTimer.start();
+}
+
+bool IdleMonitor::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::TouchBegin:
+        wake();
+        break;
+    default:
+        break;
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+void IdleMonitor::onTimeout()
+{
+    if (m_manager->isRoundActive()) {
+        m_idleTimer.start();
+        return;
+    }
+
+    setIdle(true);
+}
+
+void IdleMonitor::setIdle(bool idle)
+{
+    if (idle == m_idle) {
+        return;
+    }
+
+    m_idle = idle;
+    emit idleChanged();
+}
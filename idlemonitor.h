@@ -0,0 +1,48 @@
+#ifndef IDLEMONITOR_H
+#define IDLEMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+
+class GameManager;
+class QQuickWindow;
+
+// Tells the QML when nobody is playing or touching anything, so the start and
+// end screens can pause their particles and animations instead of drawing
+// full speed while the machine just sits there. Wakes up on any input, and
+// right away when a countdown starts.
+class IdleMonitor : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool idle READ isIdle NOTIFY idleChanged)
+
+public:
+    IdleMonitor(GameManager *manager, QQuickWindow *window);
+
+    bool isIdle() const { return m_idle; }
+
+    // Milliseconds without a round or input before going idle
+    void setTimeout(int timeout) { m_idleTimer.setInterval(timeout); }
+
+public slots:
+    void wake();
+
+signals:
+    void idleChanged();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onTimeout();
+
+private:
+    void setIdle(bool idle);
+
+    GameManager *m_manager;
+    QTimer m_idleTimer;
+    bool m_idle;
+};
+
+#endif // IDLEMONITOR_H
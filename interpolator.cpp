@@ -0,0 +1,97 @@
+#include "interpolator.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Nothing moves further than this in one tick, so anything that did was placed
+#define INTERPOLATION_MAX_DISTANCE 0.1
+
+// Where between from and to we are at progress, going the short way around the edge
+static bool interpolate(double from, double to, double progress, double *result)
+{
+    double distance = to - from;
+    if (distance > 1.0) {
+        distance -= 2.0;
+    } else if (distance < -1.0) {
+        distance += 2.0;
+    }
+
+    if (std::fabs(distance) > INTERPOLATION_MAX_DISTANCE) {
+        return false;
+    }
+
+    double position = from + distance * progress;
+    if (position > 1.0) {
+        position -= 2.0;
+    } else if (position < -1.0) {
+        position += 2.0;
+    }
+
+    *result = position;
+    return true;
+}
+
+template<typename State>
+static void interpolatePosition(const State &from, double progress, State *state)
+{
+    double x, y;
+    if (interpolate(from.x, state->x, progress, &x) && interpolate(from.y, state->y, progress, &y)) {
+        state->x = x;
+        state->y = y;
+    }
+}
+
+Interpolator::Interpolator() :
+    m_previousTime(0),
+    m_currentTime(0),
+    m_hasPrevious(false),
+    m_settled(true)
+{
+}
+
+void Interpolator::addSnapshot(const World &world, int64_t time)
+{
+    m_previous = m_current;
+    m_previousTime = m_currentTime;
+    m_hasPrevious = true;
+
+    m_current = world;
+    m_currentTime = time;
+    m_settled = false;
+}
+
+void Interpolator::update(int64_t time)
+{
+    m_ships = m_current.ships();
+    m_missiles = m_current.missiles();
+
+    // Show the previous state when the current one arrives, and move towards
+    // the current one over as long as it took to arrive, whatever the tick rate is
+    const int64_t interval = std::max<int64_t>(m_currentTime - m_previousTime, 1);
+    const double progress = std::min(double(time - m_currentTime) / interval, 1.0);
+    if (!m_hasPrevious || progress >= 1.0) {
+        m_settled = true;
+        return;
+    }
+
+    const std::vector<ShipState> &previousShips = m_previous.ships();
+    const size_t shipCount = std::min(m_ships.size(), previousShips.size());
+    for (size_t i=0; i<shipCount; i++) {
+        interpolatePosition(previousShips[i], progress, &m_ships[i]);
+    }
+
+    // Both are sorted by id, so walk through them together to find the same missiles
+    const std::vector<MissileState> &previousMissiles = m_previous.missiles();
+    size_t previous = 0;
+    for (MissileState &missile : m_missiles) {
+        while (previous < previousMissiles.size() && previousMissiles[previous].id < missile.id) {
+            previous++;
+        }
+        if (previous >= previousMissiles.size()) {
+            break;
+        }
+        if (previousMissiles[previous].id == missile.id) {
+            interpolatePosition(previousMissiles[previous], progress, &missile);
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef INTERPOLATOR_H
+#define INTERPOLATOR_H
+
+#include "world.h"
+
+#include <cstdint>
+#include <vector>
+
+// Smooths the movement between ticks for display: keeps the last two states
+// of the world, and for any point in time between them gives the positions
+// the ships and missiles should be drawn at. Things that wrap around the edge
+// slide off one side and in on the other, things that jumped further than
+// anything can move in a tick (like when a round starts) are just moved.
+class Interpolator
+{
+public:
+    Interpolator();
+
+    // Call with every new state, the time is in milliseconds from any clock
+    void addSnapshot(const World &world, int64_t time);
+
+    // Moves everything to where it should be shown at time
+    void update(int64_t time);
+
+    // True when we have reached the latest state, so nothing moves until the next one
+    bool isSettled() const { return m_settled; }
+
+    const std::vector<ShipState> &ships() const { return m_ships; }
+    const std::vector<MissileState> &missiles() const { return m_missiles; }
+
+private:
+    World m_previous;
+    World m_current;
+    int64_t m_previousTime;
+    int64_t m_currentTime;
+    bool m_hasPrevious;
+    bool m_settled;
+
+    std::vector<ShipState> m_ships;
+    std::vector<MissileState> m_missiles;
+};
+
+#endif // INTERPOLATOR_H
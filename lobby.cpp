@@ -0,0 +1,107 @@
+#include "lobby.h"
+
+#include "arena.h"
+#include "parameters.h"
+
+#include <QDebug>
+#include <QThread>
+
+Lobby::Lobby(int arenaCount, QObject *parent) : QTcpServer(parent),
+    m_arenaCount(arenaCount),
+    m_maxRounds(MAX_ROUNDS),
+    m_maxPlayers(DEFAULT_MAX_PLAYERS),
+    m_interestRadius(0),
+    m_tickInterval(DEFAULT_TICKINTERVAL)
+{
+    qRegisterMetaType<qintptr>("qintptr");
+}
+
+Lobby::~Lobby()
+{
+    close();
+
+    for (QThread *thread : m_threads) {
+        thread->quit();
+    }
+    for (QThread *thread : m_threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+bool Lobby::start(quint16 port)
+{
+    for (int i=0; i<m_arenaCount; i++) {
+        QThread *thread = new QThread;
+        Arena *arena = new Arena(i);
+        arena->setMaxRounds(m_maxRounds);
+        arena->setMaxPlayers(m_maxPlayers);
+        arena->setInterestRadius(m_interestRadius);
+        arena->setTickInterval(m_tickInterval);
+        arena->setRecordingDirectory(m_recordingDirectory);
+        arena->moveToThread(thread);
+
+        connect(thread, &QThread::started, arena, &Arena::start);
+        connect(thread, &QThread::finished, arena, &QObject::deleteLater);
+        connect(arena, &Arena::statusChanged, this, &Lobby::onStatusChanged);
+        connect(arena, &Arena::connectionRejected, this, &Lobby::onConnectionRejected);
+
+        m_arenas.append(arena);
+        m_threads.append(thread);
+        m_playerCounts.append(0);
+        m_running.append(false);
+
+        thread->start();
+    }
+
+    if (!listen(QHostAddress::Any, port)) {
+        qWarning() << "Lobby: unable to listen on port" << port << errorString();
+        return false;
+    }
+
+    qDebug() << "Lobby: listening on port" << port << "with" << m_arenaCount << "arenas";
+    return true;
+}
+
+void Lobby::incomingConnection(qintptr socketDescriptor)
+{
+    m_waiting.enqueue(socketDescriptor);
+    seatWaiting();
+}
+
+void Lobby::onStatusChanged(int arena, int playerCount, bool running)
+{
+    m_playerCounts[arena] = playerCount;
+    m_running[arena] = running;
+    seatWaiting();
+}
+
+void Lobby::onConnectionRejected(qintptr socketDescriptor)
+{
+    // We were wrong about the free seats, the arena will tell us soon enough
+    m_waiting.prepend(socketDescriptor);
+}
+
+void Lobby::seatWaiting()
+{
+    while (!m_waiting.isEmpty()) {
+        // Fill up the fullest arena first, so games get started
+        int best = -1;
+        for (int i=0; i<m_arenas.count(); i++) {
+            if (m_running[i] || m_playerCounts[i] >= m_maxPlayers) {
+                continue;
+            }
+
+            if (best < 0 || m_playerCounts[i] > m_playerCounts[best]) {
+                best = i;
+            }
+        }
+
+        if (best < 0) {
+            return;
+        }
+
+        m_playerCounts[best]++;
+        QMetaObject::invokeMethod(m_arenas[best], "addConnection", Qt::QueuedConnection, Q_ARG(qintptr, m_waiting.dequeue()));
+    }
+}
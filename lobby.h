@@ -0,0 +1,59 @@
+#ifndef LOBBY_H
+#define LOBBY_H
+
+#include <QTcpServer>
+#include <QList>
+#include <QQueue>
+#include <QVector>
+
+class Arena;
+class QThread;
+
+// Accepts all the bots on one port, and seats them in whichever arena has
+// room, each arena playing its own game on its own thread. Bots that don't
+// fit anywhere wait in line until a game finishes.
+class Lobby : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit Lobby(int arenaCount, QObject *parent = 0);
+    ~Lobby();
+
+    // Set these before start()
+    void setMaxRounds(int maxRounds) { m_maxRounds = maxRounds; }
+    void setMaxPlayers(int maxPlayers) { m_maxPlayers = maxPlayers; }
+    void setInterestRadius(double radius) { m_interestRadius = radius; }
+    void setTickInterval(int tickInterval) { m_tickInterval = tickInterval; }
+    void setRecordingDirectory(const QString &directory) { m_recordingDirectory = directory; }
+
+    bool start(quint16 port);
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private slots:
+    void onStatusChanged(int arena, int playerCount, bool running);
+    void onConnectionRejected(qintptr socketDescriptor);
+
+private:
+    void seatWaiting();
+
+    int m_arenaCount;
+    int m_maxRounds;
+    int m_maxPlayers;
+    double m_interestRadius;
+    int m_tickInterval;
+    QString m_recordingDirectory;
+
+    QList<Arena*> m_arenas;
+    QList<QThread*> m_threads;
+
+    // What we think the arenas look like, until they tell us otherwise
+    QVector<int> m_playerCounts;
+    QVector<bool> m_running;
+
+    QQueue<qintptr> m_waiting;
+};
+
+#endif // LOBBY_H
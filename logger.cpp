@@ -0,0 +1,336 @@
+#include "logger.h"
+
+#include <QFile>
+#include <QMutexLocker>
+
+#include <cstdio>
+
+// Must be a power of two
+#define LOG_BUFFER_SIZE 4096
+
+// How long the writer thread sleeps when nobody wakes it up
+#define LOG_FLUSH_INTERVAL 100
+
+#define LOG_DEFAULT_MAX_SIZE (10 * 1024 * 1024)
+#define LOG_DEFAULT_MAX_FILES 3
+
+std::atomic<Logger*> Logger::s_instance(nullptr);
+
+// Messages using the logger right now, close() waits for them before it can go away
+static std::atomic<int> s_activeMessages(0);
+
+// Counts a message as using the logger until it is released or goes out of scope
+class ActiveMessage
+{
+public:
+    ActiveMessage() : m_active(true) { s_activeMessages++; }
+    ~ActiveMessage() { release(); }
+
+    void release()
+    {
+        if (m_active) {
+            m_active = false;
+            s_activeMessages--;
+        }
+    }
+
+private:
+    bool m_active;
+};
+
+// QtMsgType isn't in order of severity
+static int severity(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return 0;
+    case QtInfoMsg:
+        return 1;
+    case QtWarningMsg:
+        return 2;
+    case QtCriticalMsg:
+        return 3;
+    case QtFatalMsg:
+        return 4;
+    }
+    return 0;
+}
+
+static const char *typeName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return "Debug";
+    case QtInfoMsg:
+        return "Info";
+    case QtWarningMsg:
+        return "Warning";
+    case QtCriticalMsg:
+        return "Critical";
+    case QtFatalMsg:
+        return "Fatal";
+    }
+    return "Unknown";
+}
+
+Logger::Logger(QObject *parent) : QThread(parent),
+    m_slots(new Slot[LOG_BUFFER_SIZE]),
+    m_enqueuePosition(0),
+    m_dequeuePosition(0),
+    m_dropped(0),
+    m_maxSize(LOG_DEFAULT_MAX_SIZE),
+    m_maxFiles(LOG_DEFAULT_MAX_FILES),
+    m_defaultLevel(severity(QtDebugMsg)),
+    m_closing(false)
+{
+    for (size_t i=0; i<LOG_BUFFER_SIZE; i++) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger()
+{
+    close();
+}
+
+void Logger::open(const QString &fileName)
+{
+    close();
+
+    m_fileName = fileName;
+    m_closing = false;
+
+    start(QThread::LowPriority);
+
+    s_instance = this;
+    qInstallMessageHandler(&Logger::handleMessage);
+}
+
+void Logger::close()
+{
+    if (s_instance == this) {
+        qInstallMessageHandler(0);
+        s_instance = nullptr;
+
+        // Someone might have picked us up just before, let them finish. Anyone
+        // coming in after this sees no logger and writes to stdout instead.
+        while (s_activeMessages > 0) {
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    stop();
+}
+
+void Logger::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_mutex.lock();
+    m_closing = true;
+    m_dataAvailable.wakeOne();
+    m_mutex.unlock();
+
+    wait();
+}
+
+bool Logger::setLevels(const QString &levels)
+{
+    static const char *levelNames[] = { "debug", "info", "warning", "critical", "fatal" };
+
+    QHash<QByteArray, int> categoryLevels;
+    int defaultLevel = severity(QtDebugMsg);
+
+    for (const QString &pair : levels.split(',', QString::SkipEmptyParts)) {
+        const int separator = pair.indexOf('=');
+        if (separator < 1) {
+            return false;
+        }
+
+        const QByteArray category = pair.left(separator).trimmed().toLatin1();
+        const QString levelName = pair.mid(separator + 1).trimmed().toLower();
+
+        int level = -1;
+        for (int i=0; i<5; i++) {
+            if (levelName == QLatin1String(levelNames[i])) {
+                level = i;
+                break;
+            }
+        }
+        if (level < 0) {
+            return false;
+        }
+
+        if (category == "*") {
+            defaultLevel = level;
+        } else {
+            categoryLevels[category] = level;
+        }
+    }
+
+    m_levels = categoryLevels;
+    m_defaultLevel = defaultLevel;
+    return true;
+}
+
+void Logger::handleMessage(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    ActiveMessage active;
+    Logger *logger = s_instance;
+    if (!logger) {
+        active.release();
+    }
+
+    const char *category = context.category ? context.category : "default";
+    if (logger && !logger->isEnabled(type, category)) {
+        return;
+    }
+
+    const QByteArray line = QString("%1: %2 (%3:%4, %5)").arg(typeName(type)).arg(message).arg(context.file).arg(context.line).arg(context.function).toLocal8Bit() + '\n';
+
+    // We're about to abort, so everything has to be written before returning
+    if (type == QtFatalMsg || !logger) {
+        if (logger) {
+            // Not close(), that would wait for this message too
+            logger->stop();
+            logger->writeSynchronously(line);
+        } else {
+            fwrite(line.constData(), 1, line.size(), stdout);
+            fflush(stdout);
+        }
+        return;
+    }
+
+    if (!logger->push(line)) {
+        logger->m_dropped++;
+    }
+
+    // Don't wait for the timeout when we're getting full
+    const size_t queued = logger->m_enqueuePosition.load(std::memory_order_relaxed) - logger->m_dequeuePosition.load(std::memory_order_relaxed);
+    if (queued > LOG_BUFFER_SIZE / 2) {
+        logger->m_dataAvailable.wakeOne();
+    }
+}
+
+bool Logger::isEnabled(QtMsgType type, const char *category) const
+{
+    // No allocation, we just need it for the lookup
+    const QByteArray key = QByteArray::fromRawData(category, int(qstrlen(category)));
+    return severity(type) >= m_levels.value(key, m_defaultLevel);
+}
+
+// A bounded multi producer queue, every slot has a sequence number telling
+// whether it is free for the producer at that position or filled for the consumer
+bool Logger::push(const QByteArray &line)
+{
+    size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    Slot *slot;
+    forever {
+        slot = &m_slots[position & (LOG_BUFFER_SIZE - 1)];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const intptr_t difference = intptr_t(sequence) - intptr_t(position);
+
+        if (difference == 0) {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The writer hasn't caught up yet
+            return false;
+        } else {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->line = line;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// Only called from the writer thread
+bool Logger::pop(QByteArray *line)
+{
+    const size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    Slot &slot = m_slots[position & (LOG_BUFFER_SIZE - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+
+    line->swap(slot.line);
+    slot.line.clear();
+    slot.sequence.store(position + LOG_BUFFER_SIZE, std::memory_order_release);
+    m_dequeuePosition.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void Logger::writeSynchronously(const QByteArray &line)
+{
+    QFile file(m_fileName);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        file.write(line);
+    }
+
+    fwrite(line.constData(), 1, line.size(), stdout);
+    fflush(stdout);
+}
+
+void Logger::rotate()
+{
+    QFile::remove(m_fileName + '.' + QString::number(m_maxFiles));
+    for (int i=m_maxFiles - 1; i>0; i--) {
+        QFile::rename(m_fileName + '.' + QString::number(i), m_fileName + '.' + QString::number(i + 1));
+    }
+    QFile::rename(m_fileName, m_fileName + ".1");
+}
+
+void Logger::run()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        fprintf(stderr, "Logger: unable to open %s\n", qPrintable(m_fileName));
+    }
+
+    QByteArray line;
+    forever {
+        m_mutex.lock();
+        if (!m_closing) {
+            m_dataAvailable.wait(&m_mutex, LOG_FLUSH_INTERVAL);
+        }
+        const bool closing = m_closing;
+        m_mutex.unlock();
+
+        QByteArray pending;
+        while (pop(&line)) {
+            pending += line;
+        }
+
+        const int dropped = m_dropped.exchange(0);
+        if (dropped > 0) {
+            pending += "Warning: dropped " + QByteArray::number(dropped) + " log messages, the log buffer was full\n";
+        }
+
+        if (!pending.isEmpty()) {
+            if (file.isOpen()) {
+                file.write(pending);
+                file.flush();
+
+                if (m_maxSize > 0 && m_maxFiles > 0 && file.size() > m_maxSize) {
+                    file.close();
+                    rotate();
+                    file.open(QIODevice::WriteOnly | QIODevice::Append);
+                }
+            }
+
+            fwrite(pending.constData(), 1, pending.size(), stdout);
+            fflush(stdout);
+        }
+
+        if (closing) {
+            break;
+        }
+    }
+
+    file.close();
+}
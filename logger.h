@@ -0,0 +1,80 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+
+#include <atomic>
+#include <memory>
+
+// Takes over the Qt message handler, and writes the messages to a log file and
+// stdout from a background thread. Messages are put in a fixed size ring buffer
+// without taking any locks, so logging never waits for the disk. When the
+// buffer is full new messages are dropped, and how many is written to the log.
+class Logger : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit Logger(QObject *parent = 0);
+    ~Logger();
+
+    // Starts the writer thread and installs the message handler
+    void open(const QString &fileName);
+
+    // Writes everything still queued, stops the thread and restores the default message handler
+    void close();
+
+    // When the log file grows past maxSize bytes it is renamed to <fileName>.1, and so on up to files
+    void setRotation(qint64 maxSize, int files) { m_maxSize = maxSize; m_maxFiles = files; }
+
+    // Comma separated <category>=<level> pairs, where the level is debug, info, warning,
+    // critical or fatal, and * sets the level for all other categories.
+    // Not thread safe, so set it before starting any other threads.
+    bool setLevels(const QString &levels);
+
+protected:
+    void run() override;
+
+private:
+    static void handleMessage(QtMsgType type, const QMessageLogContext &context, const QString &message);
+
+    // Writes everything still queued and stops the thread, without waiting for anyone logging
+    void stop();
+
+    bool isEnabled(QtMsgType type, const char *category) const;
+    bool push(const QByteArray &line);
+    bool pop(QByteArray *line);
+    void writeSynchronously(const QByteArray &line);
+    void rotate();
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        QByteArray line;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<size_t> m_enqueuePosition;
+    std::atomic<size_t> m_dequeuePosition;
+    std::atomic<int> m_dropped;
+
+    QString m_fileName;
+    qint64 m_maxSize;
+    int m_maxFiles;
+
+    QHash<QByteArray, int> m_levels;
+    int m_defaultLevel;
+
+    QMutex m_mutex;
+    QWaitCondition m_dataAvailable;
+    std::atomic<bool> m_closing;
+
+    static std::atomic<Logger*> s_instance;
+};
+
+#endif // LOGGER_H
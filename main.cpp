@@ -1,5 +1,19 @@
 #include "gamemanager.h"
 #include "settings.h"
+#include "replay.h"
+#include "matchrunner.h"
+#include "lobby.h"
+#include "coordinator.h"
+#include "tournamentworker.h"
+#include "scheduler.h"
+#include "logger.h"
+#include "missilerenderer.h"
+#include "playerrenderer.h"
+#include "particlebudget.h"
+#include "performancemonitor.h"
+#include "videoexporter.h"
+#include "idlemonitor.h"
+#include "playersprites.h"
 
 #include <QGuiApplication>
 #include <QQmlContext>
@@ -7,35 +21,9 @@
 #include <QtQml>
 #include <QQuickItem>
 #include <QFontDatabase>
+#include <QThread>
 #include <iostream>
-
-void myMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
-{
-    QString txt;
-    switch (type) {
-    case QtDebugMsg:
-        txt = QString("Debug: %1 (%2:%3, %4)").arg(msg).arg(context.file).arg(context.line).arg(context.function);
-        break;
-    case QtInfoMsg:
-        txt = QString("Info: %1 (%2:%3, %4)").arg(msg).arg(context.file).arg(context.line).arg(context.function);
-    break;
-    case QtWarningMsg:
-        txt = QString("Warning: %1 (%2:%3, %4)").arg(msg).arg(context.file).arg(context.line).arg(context.function);
-    break;
-    case QtCriticalMsg:
-        txt = QString("Critical: %1 (%2:%3, %4)").arg(msg).arg(context.file).arg(context.line).arg(context.function);
-    break;
-    case QtFatalMsg:
-        txt = QString("Fatal: %1 (%2:%3, %4)").arg(msg).arg(context.file).arg(context.line).arg(context.function);
-    break;
-    }
-    QFile outFile("log.txt");
-    outFile.open(QIODevice::WriteOnly | QIODevice::Append);
-    QTextStream ts(&outFile);
-    ts << txt << endl;
-
-    std::cout << txt.toStdString() << std::endl;
-}
+#include <random>
 
 #define ARGUMENT_TICK_INTERVAL "tick-interval"
 #define ARGUMENT_START_AT "start-at"
@@ -43,36 +31,649 @@ void myMessageHandler(QtMsgType type, const QMessageLogContext &context, const Q
 #define ARGUMENT_QUIT_ON_FINISH "quit-on-finish"
 #define ARGUMENT_FULLSCREEN "fullscreen"
 #define ARGUMENT_ROUNDS "rounds"
+#define ARGUMENT_RECORD "record"
+#define ARGUMENT_REPLAY "replay"
+#define ARGUMENT_SEED "seed"
+#define ARGUMENT_DIGEST "digest"
+#define ARGUMENT_INTEREST_RADIUS "interest-radius"
+#define ARGUMENT_COMPARE "compare"
+#define ARGUMENT_MATCHES "matches"
+#define ARGUMENT_BOTS "bots"
+#define ARGUMENT_THREADS "threads"
+#define ARGUMENT_ARENAS "arenas"
+#define ARGUMENT_HEADLESS "headless"
+#define ARGUMENT_STATUS "status"
+#define ARGUMENT_PORT "port"
+#define ARGUMENT_RESULTS "results"
+#define ARGUMENT_ROUND_RESULTS "round-results"
+#define ARGUMENT_COORDINATOR "coordinator"
+#define ARGUMENT_POOL "pool"
+#define ARGUMENT_GROUP_SIZE "group-size"
+#define ARGUMENT_MATCHES_PER_BOT "matches-per-bot"
+#define ARGUMENT_MAX_PLAYERS "max-players"
+#define ARGUMENT_WORKER "worker"
+#define ARGUMENT_SLOTS "slots"
+#define ARGUMENT_TOURNAMENT "tournament"
+#define ARGUMENT_CACHE "cache"
+#define ARGUMENT_LOG_LEVELS "log-levels"
+#define ARGUMENT_EXPORT "export"
+#define ARGUMENT_OUTPUT "output"
+#define ARGUMENT_FPS "fps"
+#define ARGUMENT_SIZE "size"
+#define ARGUMENT_RAW "raw"
+
+static int compareRecordings(const QStringList &fileNames)
+{
+    if (fileNames.count() != 2) {
+        std::cerr << "Need exactly two recordings to compare" << std::endl;
+        return 2;
+    }
+
+    Replay first, second;
+    if (!first.open(fileNames[0])) {
+        std::cerr << "Unable to open " << fileNames[0].toStdString() << ": " << first.errorString().toStdString() << std::endl;
+        return 2;
+    }
+    if (!second.open(fileNames[1])) {
+        std::cerr << "Unable to open " << fileNames[1].toStdString() << ": " << second.errorString().toStdString() << std::endl;
+        return 2;
+    }
+
+    const int divergence = Replay::firstDivergence(first, second);
+    if (divergence < 0) {
+        std::cout << "Identical, " << first.frameCount() << " frames" << std::endl;
+        return 0;
+    }
+
+    ReplayFrame frame;
+    if (first.frame(divergence, &frame) || second.frame(divergence, &frame)) {
+        std::cout << "Diverged at frame " << divergence << " (round " << frame.header->round << ", tick " << frame.header->tick << ")" << std::endl;
+    } else {
+        std::cout << "Diverged at frame " << divergence << std::endl;
+    }
+    return 1;
+}
+
+static int runMatches(QCommandLineParser &parser)
+{
+    bool ok;
+    const int matchCount = parser.value(ARGUMENT_MATCHES).toInt(&ok);
+    if (!ok || matchCount < 1) {
+        parser.showHelp(-1);
+    }
+
+    MatchConfig config;
+    config.rounds = MAX_ROUNDS;
+    config.maxTicks = 10000;
+
+    if (parser.isSet(ARGUMENT_ROUNDS)) {
+        config.rounds = parser.value(ARGUMENT_ROUNDS).toInt(&ok);
+        if (!ok || config.rounds < 1) {
+            parser.showHelp(-1);
+        }
+    }
+
+    if (parser.isSet(ARGUMENT_SEED)) {
+        config.seed = parser.value(ARGUMENT_SEED).toULongLong(&ok);
+        if (!ok) {
+            parser.showHelp(-1);
+        }
+    } else {
+        std::random_device randomDevice;
+        config.seed = (quint64(randomDevice()) << 32) | randomDevice();
+    }
+
+    QStringList bots = QStringList() << "random" << "random" << "random" << "random";
+    if (parser.isSet(ARGUMENT_BOTS)) {
+        bots = parser.value(ARGUMENT_BOTS).split(',', QString::SkipEmptyParts);
+    }
+    if (bots.isEmpty() || bots.count() > MAX_PLAYERS) {
+        parser.showHelp(-1);
+    }
+    for (const QString &bot : bots) {
+        std::unique_ptr<Bot> test(createBot(bot.toStdString(), 0));
+        if (!test) {
+            std::cerr << "Unknown bot " << bot.toStdString() << std::endl;
+            return 1;
+        }
+        config.bots.push_back(bot.toStdString());
+    }
+
+    int threadCount = QThread::idealThreadCount();
+    if (parser.isSet(ARGUMENT_THREADS)) {
+        threadCount = parser.value(ARGUMENT_THREADS).toInt(&ok);
+        if (!ok || threadCount < 1) {
+            parser.showHelp(-1);
+        }
+    }
+
+    // Each match gets the next seed, so any of them can be played again on its own
+    std::vector<MatchConfig> configs;
+    for (int i=0; i<matchCount; i++) {
+        configs.push_back(config);
+        configs.back().seed = config.seed + i;
+    }
+
+    MatchRunner runner(threadCount);
+    const std::vector<MatchResult> results = runner.run(configs);
+
+    // One line per bot: name, wins, score and energy left
+    for (size_t i=0; i<results.size(); i++) {
+        const MatchResult &result = results[i];
+        std::cout << "match " << i << " seed " << result.seed << std::endl;
+        for (size_t player=0; player<result.bots.size(); player++) {
+            std::cout << result.bots[player] << ' ' << result.wins[player] << ' ' << result.scores[player] << ' ' << result.energy[player] << std::endl;
+        }
+    }
+
+    return 0;
+}
+
+static int maxPlayers(QCommandLineParser &parser)
+{
+    if (!parser.isSet(ARGUMENT_MAX_PLAYERS)) {
+        return DEFAULT_MAX_PLAYERS;
+    }
+
+    bool ok;
+    const int maxPlayers = parser.value(ARGUMENT_MAX_PLAYERS).toInt(&ok);
+    if (!ok || maxPlayers < 1 || maxPlayers > MAX_PLAYERS) {
+        parser.showHelp(-1);
+    }
+    return maxPlayers;
+}
+
+static double interestRadius(QCommandLineParser &parser)
+{
+    if (!parser.isSet(ARGUMENT_INTEREST_RADIUS)) {
+        return 0;
+    }
+
+    bool ok;
+    const double radius = parser.value(ARGUMENT_INTEREST_RADIUS).toDouble(&ok);
+    if (!ok || !qIsFinite(radius) || radius < 0) {
+        parser.showHelp(-1);
+    }
+    return qMin(radius, 2.0);
+}
+
+static int runLobby(QCommandLineParser &parser, QCoreApplication *app)
+{
+    bool ok;
+    const int arenaCount = parser.value(ARGUMENT_ARENAS).toInt(&ok);
+    if (!ok || arenaCount < 1) {
+        parser.showHelp(-1);
+    }
+
+    Lobby lobby(arenaCount);
+    lobby.setMaxPlayers(maxPlayers(parser));
+    lobby.setInterestRadius(interestRadius(parser));
+
+    if (parser.isSet(ARGUMENT_ROUNDS)) {
+        int rounds = parser.value(ARGUMENT_ROUNDS).toInt();
+        if (rounds > 0) {
+            lobby.setMaxRounds(rounds);
+        }
+    }
+
+    if (parser.isSet(ARGUMENT_TICK_INTERVAL)) {
+        int tickInterval = parser.value(ARGUMENT_TICK_INTERVAL).toInt();
+        if (tickInterval < 10 || tickInterval > 1000) {
+            parser.showHelp(-1);
+        }
+        lobby.setTickInterval(tickInterval);
+    }
+
+    if (parser.isSet(ARGUMENT_RECORD)) {
+        lobby.setRecordingDirectory(parser.value(ARGUMENT_RECORD));
+    }
+
+    if (!lobby.start(DEFAULT_PORT)) {
+        return 1;
+    }
+
+    return app->exec();
+}
+
+// The bots from --pool or --bots, false if the pool file can't be read
+static bool readBotPool(QCommandLineParser &parser, QStringList *bots)
+{
+    // One bot per line, either a built in one or a command line
+    if (parser.isSet(ARGUMENT_POOL)) {
+        QFile poolFile(parser.value(ARGUMENT_POOL));
+        if (!poolFile.open(QIODevice::ReadOnly)) {
+            std::cerr << "Unable to open " << poolFile.fileName().toStdString() << ": " << poolFile.errorString().toStdString() << std::endl;
+            return false;
+        }
+        for (const QByteArray &line : poolFile.readAll().split('\n')) {
+            const QString bot = QString::fromUtf8(line).trimmed();
+            if (!bot.isEmpty() && !bot.startsWith('#')) {
+                bots->append(bot);
+            }
+        }
+    } else if (parser.isSet(ARGUMENT_BOTS)) {
+        *bots = parser.value(ARGUMENT_BOTS).split(',', QString::SkipEmptyParts);
+    } else {
+        parser.showHelp(-1);
+    }
+
+    return true;
+}
+
+static int runTournament(QCommandLineParser &parser)
+{
+    bool ok;
+    const int maxMatches = parser.value(ARGUMENT_TOURNAMENT).toInt(&ok);
+    if (!ok || maxMatches < 1) {
+        parser.showHelp(-1);
+    }
+
+    QStringList bots;
+    if (!readBotPool(parser, &bots)) {
+        return 1;
+    }
+    if (!isBuiltinMatch(bots)) {
+        std::cerr << "Only built in bots can play in --" ARGUMENT_TOURNAMENT ", use --" ARGUMENT_COORDINATOR " for the others" << std::endl;
+        return 1;
+    }
+
+    int groupSize = qMin(DEFAULT_MAX_PLAYERS, bots.count());
+    if (parser.isSet(ARGUMENT_GROUP_SIZE)) {
+        groupSize = parser.value(ARGUMENT_GROUP_SIZE).toInt(&ok);
+        if (!ok || groupSize > MAX_PLAYERS || groupSize > bots.count()) {
+            parser.showHelp(-1);
+        }
+    }
+    if (groupSize < 2) {
+        std::cerr << "Need at least two bots" << std::endl;
+        return 1;
+    }
+
+    int rounds = MAX_ROUNDS;
+    if (parser.isSet(ARGUMENT_ROUNDS)) {
+        rounds = parser.value(ARGUMENT_ROUNDS).toInt(&ok);
+        if (!ok || rounds < 1) {
+            parser.showHelp(-1);
+        }
+    }
+
+    quint64 seed;
+    if (parser.isSet(ARGUMENT_SEED)) {
+        seed = parser.value(ARGUMENT_SEED).toULongLong(&ok);
+        if (!ok) {
+            parser.showHelp(-1);
+        }
+    } else {
+        std::random_device randomDevice;
+        seed = (quint64(randomDevice()) << 32) | randomDevice();
+    }
+
+    int threadCount = QThread::idealThreadCount();
+    if (parser.isSet(ARGUMENT_THREADS)) {
+        threadCount = parser.value(ARGUMENT_THREADS).toInt(&ok);
+        if (!ok || threadCount < 1) {
+            parser.showHelp(-1);
+        }
+    }
+
+    std::vector<std::string> pool;
+    for (const QString &bot : bots) {
+        pool.push_back(bot.toStdString());
+    }
+
+    TournamentScheduler scheduler(pool, groupSize, rounds, seed);
+    MatchRunner runner(threadCount);
+    runner.setFinishedCallback([&scheduler](int, const MatchResult &result) {
+        scheduler.addResult(result);
+    });
+
+    // A few matches per thread at a time, so the ratings get to steer the next ones
+    while (!scheduler.hasConverged() && scheduler.matchesPlayed() < maxMatches) {
+        const int count = qMin(threadCount * 4, maxMatches - scheduler.matchesPlayed());
+        const std::vector<MatchConfig> matches = scheduler.nextMatches(count);
+        if (matches.empty()) {
+            break;
+        }
+
+        runner.run(matches);
+        qDebug() << "Tournament:" << scheduler.matchesPlayed() << "matches played";
+    }
+
+    // Best first
+    for (const TournamentScheduler::Standing &standing : scheduler.standings()) {
+        std::cout << QString::number(standing.rating.conservative(), 'f', 2).toStdString() << ' '
+                  << QString::number(standing.rating.mu, 'f', 2).toStdString() << ' '
+                  << QString::number(standing.rating.sigma, 'f', 2).toStdString() << ' '
+                  << standing.rating.matches << ' '
+                  << standing.name << std::endl;
+    }
+
+    return 0;
+}
+
+static int runCoordinator(QCommandLineParser &parser, QCoreApplication *app)
+{
+    bool ok;
+    const int port = parser.value(ARGUMENT_COORDINATOR).toInt(&ok);
+    if (!ok || port < 1 || port > 65535) {
+        parser.showHelp(-1);
+    }
+
+    QStringList bots;
+    if (!readBotPool(parser, &bots)) {
+        return 1;
+    }
+
+    int groupSize = qMin(DEFAULT_MAX_PLAYERS, bots.count());
+    if (parser.isSet(ARGUMENT_GROUP_SIZE)) {
+        groupSize = parser.value(ARGUMENT_GROUP_SIZE).toInt(&ok);
+        if (!ok || groupSize < 1 || groupSize > MAX_PLAYERS || groupSize > bots.count()) {
+            parser.showHelp(-1);
+        }
+    }
+
+    int rounds = MAX_ROUNDS;
+    if (parser.isSet(ARGUMENT_ROUNDS)) {
+        rounds = parser.value(ARGUMENT_ROUNDS).toInt(&ok);
+        if (!ok || rounds < 1) {
+            parser.showHelp(-1);
+        }
+    }
+
+    int tickInterval = 0;
+    if (parser.isSet(ARGUMENT_TICK_INTERVAL)) {
+        tickInterval = parser.value(ARGUMENT_TICK_INTERVAL).toInt();
+        if (tickInterval < 10 || tickInterval > 1000) {
+            parser.showHelp(-1);
+        }
+    }
+
+    // A random seed makes every match new, so nothing would ever come from the cache
+    if (parser.isSet(ARGUMENT_CACHE) && !parser.isSet(ARGUMENT_SEED)) {
+        std::cerr << "--" ARGUMENT_CACHE " needs a fixed --" ARGUMENT_SEED << std::endl;
+        return 1;
+    }
+
+    quint64 seed;
+    if (parser.isSet(ARGUMENT_SEED)) {
+        seed = parser.value(ARGUMENT_SEED).toULongLong(&ok);
+        if (!ok) {
+            parser.showHelp(-1);
+        }
+    } else {
+        std::random_device randomDevice;
+        seed = (quint64(randomDevice()) << 32) | randomDevice();
+    }
+
+    // Every group plays if there aren't too many of them, otherwise random ones
+    QList<MatchAssignment> assignments;
+    if (parser.isSet(ARGUMENT_MATCHES_PER_BOT)) {
+        const int matchesPerBot = parser.value(ARGUMENT_MATCHES_PER_BOT).toInt(&ok);
+        if (!ok || matchesPerBot < 1) {
+            parser.showHelp(-1);
+        }
+        assignments = balancedGroups(bots, groupSize, matchesPerBot, rounds, tickInterval, seed);
+    } else if (roundRobinSize(bots.count(), groupSize) > 0) {
+        assignments = roundRobin(bots, groupSize, rounds, tickInterval, seed);
+    }
+    if (assignments.isEmpty()) {
+        std::cerr << "More than " << TOURNAMENT_MAX_MATCHES << " matches to play, use a smaller pool or --" ARGUMENT_MATCHES_PER_BOT " <count>" << std::endl;
+        return 1;
+    }
+
+    Coordinator coordinator(assignments);
+    QObject::connect(&coordinator, &Coordinator::finished, app, &QCoreApplication::quit, Qt::QueuedConnection);
+    if (parser.isSet(ARGUMENT_CACHE) && !coordinator.openCache(parser.value(ARGUMENT_CACHE))) {
+        return 1;
+    }
+    if (!coordinator.listen(port)) {
+        return 1;
+    }
+
+    return app->exec();
+}
+
+static int runWorker(QCommandLineParser &parser, QCoreApplication *app)
+{
+    const QString address = parser.value(ARGUMENT_WORKER);
+    const int separator = address.lastIndexOf(':');
+    bool ok;
+    const int port = address.mid(separator + 1).toInt(&ok);
+    if (separator < 1 || !ok || port < 1 || port > 65535) {
+        parser.showHelp(-1);
+    }
+
+    int slots = 1;
+    if (parser.isSet(ARGUMENT_SLOTS)) {
+        slots = parser.value(ARGUMENT_SLOTS).toInt(&ok);
+        if (!ok || slots < 1) {
+            parser.showHelp(-1);
+        }
+    }
+
+    int gamePort = DEFAULT_PORT;
+    if (parser.isSet(ARGUMENT_PORT)) {
+        gamePort = parser.value(ARGUMENT_PORT).toInt(&ok);
+        if (!ok || gamePort < 1 || gamePort + slots > 65536) {
+            parser.showHelp(-1);
+        }
+    }
+
+    TournamentWorker worker(address.left(separator), port, slots, gamePort);
+    QObject::connect(&worker, &TournamentWorker::finished, app, &QCoreApplication::quit, Qt::QueuedConnection);
+    worker.start();
+
+    return app->exec();
+}
+
+// The types used by the game scene, in a window or offscreen
+static void registerQmlTypes()
+{
+    qmlRegisterSingletonType<Settings>("org.gathering.turnonme", 1, 0, "Settings", [](QQmlEngine *, QJSEngine*) -> QObject* {
+        return new Settings;
+    });
+    qmlRegisterType<MissileRenderer>("org.gathering.turnonme", 1, 0, "MissileRenderer");
+    qmlRegisterType<PlayerRenderer>("org.gathering.turnonme", 1, 0, "PlayerRenderer");
+}
+
+static int runExport(QCommandLineParser &parser)
+{
+    VideoExporter exporter;
+
+    if (parser.isSet(ARGUMENT_FPS)) {
+        bool ok;
+        const int frameRate = parser.value(ARGUMENT_FPS).toInt(&ok);
+        if (!ok || frameRate < 1 || frameRate > 240) {
+            parser.showHelp(-1);
+        }
+        exporter.setFrameRate(frameRate);
+    }
+
+    if (parser.isSet(ARGUMENT_SIZE)) {
+        const QStringList size = parser.value(ARGUMENT_SIZE).split('x');
+        if (size.count() != 2 || size[0].toInt() < 1 || size[1].toInt() < 1) {
+            parser.showHelp(-1);
+        }
+        exporter.setSize(QSize(size[0].toInt(), size[1].toInt()));
+    }
+
+    exporter.setRaw(parser.isSet(ARGUMENT_RAW));
+
+    QFontDatabase::addApplicationFont(":/Aldrich_Regular.ttf");
+    QGuiApplication::setFont(QFont("Aldrich"));
+    registerQmlTypes();
+    VideoExporter::prepare();
+
+    const QString outputDirectory = parser.isSet(ARGUMENT_OUTPUT) ? parser.value(ARGUMENT_OUTPUT) : QStringLiteral("frames");
+    if (!exporter.exportReplay(parser.value(ARGUMENT_EXPORT), outputDirectory)) {
+        std::cerr << "Export failed: " << qPrintable(exporter.errorString()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Matches between built in bots, the lobby and the tournament don't need a display
+static QCoreApplication *createApplication(int &argc, char *argv[])
+{
+    static const char *headlessArguments[] = {
+        "--" ARGUMENT_MATCHES,
+        "--" ARGUMENT_ARENAS,
+        "--" ARGUMENT_HEADLESS,
+        "--" ARGUMENT_COORDINATOR,
+        "--" ARGUMENT_WORKER,
+        "--" ARGUMENT_TOURNAMENT
+    };
+
+    for (int i=1; i<argc; i++) {
+        const QByteArray argument(argv[i]);
+        for (const char *headlessArgument : headlessArguments) {
+            if (argument.startsWith(headlessArgument)) {
+                return new QCoreApplication(argc, argv);
+            }
+        }
+    }
+
+    // Exporting doesn't need a display
+    for (int i=1; i<argc; i++) {
+        if (QByteArray(argv[i]).startsWith("--" ARGUMENT_EXPORT) && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+    return new QGuiApplication(argc, argv);
+}
 
 int main(int argc, char *argv[])
 {
-    qInstallMessageHandler(myMessageHandler);
-    QGuiApplication app(argc, argv);
+    Logger logger;
+    logger.open("log.txt");
+    QScopedPointer<QCoreApplication> app(createApplication(argc, argv));
 
     QCommandLineParser parser;
     parser.addHelpOption();
-    parser.addOption({ARGUMENT_START_AT, "Automatically start the game after <players> players (1 - 4) has connected.", "players"});
+    parser.addOption({ARGUMENT_START_AT, "Automatically start the game after <players> players (1 - --" ARGUMENT_MAX_PLAYERS ") has connected.", "players"});
     parser.addOption({{"i", ARGUMENT_TICK_INTERVAL}, "Set the tick interval to <ms> milliseconds (10 - 1000).", "ms"});
     parser.addOption({ARGUMENT_QUIT_ON_FINISH, "Exit the game after playing all rounds."});
     parser.addOption({ARGUMENT_FULLSCREEN, "Start in fullscreen."});
     parser.addOption({ARGUMENT_ROUNDS, "Rounds to play.", "rounds"});
-    parser.process(app);
+    parser.addOption({ARGUMENT_RECORD, "Record every match played into <directory>.", "directory"});
+    parser.addOption({ARGUMENT_REPLAY, "Play back the recorded match in <file>.", "file"});
+    parser.addOption({ARGUMENT_SEED, "Seed every game with <seed>, instead of a random one.", "seed"});
+    parser.addOption({ARGUMENT_DIGEST, "Include a hash of the game state in each stateupdate."});
+    parser.addOption({ARGUMENT_INTEREST_RADIUS, "Only send each bot the players and missiles within <radius> (the area is 2 wide) of it, unless it asks for something else.", "radius"});
+    parser.addOption({ARGUMENT_COMPARE, "Compare two recordings, and print the first tick where they differ."});
+    parser.addOption({ARGUMENT_MATCHES, "Play <count> matches between built in bots as fast as possible, without any window, and print the scores.", "count"});
+    parser.addOption({ARGUMENT_BOTS, "Comma separated list of the built in bots to play with --" ARGUMENT_MATCHES " (idle, random, rollout).", "bots"});
+    parser.addOption({ARGUMENT_THREADS, "Threads to play --" ARGUMENT_MATCHES " on, defaults to one per core.", "threads"});
+    parser.addOption({ARGUMENT_ARENAS, "Run <count> games at the same time without any window, and seat everyone connecting in whichever has room.", "count"});
+    parser.addOption({ARGUMENT_MAX_PLAYERS, "Let up to <players> (1 - " QT_STRINGIFY(MAX_PLAYERS) ") play in each game, instead of " QT_STRINGIFY(DEFAULT_MAX_PLAYERS) ".", "players"});
+    parser.addOption({ARGUMENT_HEADLESS, "Run the game without any window."});
+    parser.addOption({ARGUMENT_STATUS, "Print a STATUS line to stdout when the game is listening and when each player connects, for scripts starting it."});
+    parser.addOption({ARGUMENT_PORT, "Listen for players on <port> instead of " QT_STRINGIFY(DEFAULT_PORT) ". For --" ARGUMENT_WORKER ", the first port to run games on.", "port"});
+    parser.addOption({ARGUMENT_RESULTS, "Write the final scores as JSON to <file>.", "file"});
+    parser.addOption({ARGUMENT_ROUND_RESULTS, "Append a JSON record of every round to <file> instead of results.jsonl.", "file"});
+    parser.addOption({ARGUMENT_COORDINATOR, "Run a tournament between the --" ARGUMENT_BOTS " or the --" ARGUMENT_POOL ", and hand out the matches to workers connecting on <port>.", "port"});
+    parser.addOption({ARGUMENT_POOL, "File with the bots for --" ARGUMENT_COORDINATOR ", one built in bot or command line per line, {port} is replaced with the port to connect to.", "file"});
+    parser.addOption({ARGUMENT_GROUP_SIZE, "Players in each match of the tournament, defaults to " QT_STRINGIFY(DEFAULT_MAX_PLAYERS) ".", "players"});
+    parser.addOption({ARGUMENT_MATCHES_PER_BOT, "Instead of every group of bots playing, let each bot of the --" ARGUMENT_COORDINATOR " play <count> matches in random groups. For pools too big to play every group.", "count"});
+    parser.addOption({ARGUMENT_WORKER, "Play tournament matches for the coordinator at <host:port>.", "host:port"});
+    parser.addOption({ARGUMENT_SLOTS, "Matches to play at the same time with --" ARGUMENT_WORKER ".", "count"});
+    parser.addOption({ARGUMENT_TOURNAMENT, "Rate the built in --" ARGUMENT_BOTS " or --" ARGUMENT_POOL " against each other, playing at most <matches> matches, and print the ratings.", "matches"});
+    parser.addOption({ARGUMENT_CACHE, "Keep the results of --" ARGUMENT_COORDINATOR " matches in <file>, and don't play them again unless the bots, seed or rules change. Needs --" ARGUMENT_SEED ".", "file"});
+    parser.addOption({ARGUMENT_EXPORT, "Render the recorded match in <file> to images as fast as possible, without any window.", "file"});
+    parser.addOption({ARGUMENT_OUTPUT, "Directory to write the images from --" ARGUMENT_EXPORT " to, defaults to frames.", "directory"});
+    parser.addOption({ARGUMENT_FPS, "Frames per second to --" ARGUMENT_EXPORT ", defaults to 60.", "fps"});
+    parser.addOption({ARGUMENT_SIZE, "Size of the images from --" ARGUMENT_EXPORT ", defaults to 1280x720.", "widthxheight"});
+    parser.addOption({ARGUMENT_RAW, "Write all frames from --" ARGUMENT_EXPORT " as raw 24 bit RGB into frames.rgb instead of one PNG file each."});
+    parser.addPositionalArgument("recordings", "The two recordings to compare, with --" ARGUMENT_COMPARE ".", "[first second]");
+    parser.addOption({ARGUMENT_LOG_LEVELS, "Only log messages of at least <levels>, e.g. *=warning,qml=debug. The levels are debug, info, warning, critical and fatal.", "levels"});
+    parser.process(*app);
 
-    QFontDatabase::addApplicationFont(":/Aldrich_Regular.ttf");
-    app.setFont(QFont("Aldrich"));
+    if (parser.isSet(ARGUMENT_LOG_LEVELS) && !logger.setLevels(parser.value(ARGUMENT_LOG_LEVELS))) {
+        parser.showHelp(-1);
+    }
 
-    app.setOrganizationDomain("gathering.org");
-    app.setApplicationName("Turn On Me");
+    if (parser.isSet(ARGUMENT_COMPARE)) {
+        return compareRecordings(parser.positionalArguments());
+    }
 
-    qmlRegisterSingletonType<Settings>("org.gathering.turnonme", 1, 0, "Settings", [](QQmlEngine *, QJSEngine*) -> QObject* {
-        return new Settings;
-    });
+    if (parser.isSet(ARGUMENT_MATCHES)) {
+        return runMatches(parser);
+    }
+
+    if (parser.isSet(ARGUMENT_ARENAS)) {
+        return runLobby(parser, app.data());
+    }
+
+    if (parser.isSet(ARGUMENT_TOURNAMENT)) {
+        return runTournament(parser);
+    }
+
+    if (parser.isSet(ARGUMENT_COORDINATOR)) {
+        return runCoordinator(parser, app.data());
+    }
+
+    if (parser.isSet(ARGUMENT_WORKER)) {
+        return runWorker(parser, app.data());
+    }
 
+    const bool headless = parser.isSet(ARGUMENT_HEADLESS);
 
-    QQuickView view;
-    QObject::connect(view.engine(), &QQmlEngine::quit, &app, &QGuiApplication::quit);
-    view.setResizeMode(QQuickView::SizeRootObjectToView);
-    GameManager manager(&view);
+    app->setOrganizationDomain("gathering.org");
+    app->setApplicationName("Turn On Me");
+
+    if (parser.isSet(ARGUMENT_EXPORT)) {
+        return runExport(parser);
+    }
+
+    QScopedPointer<QQuickView> view;
+    ParticleBudget *particleBudget = nullptr;
+    if (!headless) {
+        QFontDatabase::addApplicationFont(":/Aldrich_Regular.ttf");
+        QGuiApplication::setFont(QFont("Aldrich"));
+
+        registerQmlTypes();
+
+        view.reset(new QQuickView);
+        view->engine()->addImageProvider("players", new PlayerSpriteProvider);
+        QObject::connect(view->engine(), &QQmlEngine::quit, app.data(), &QCoreApplication::quit);
+        view->setResizeMode(QQuickView::SizeRootObjectToView);
+
+        particleBudget = new ParticleBudget(view.data());
+        view->rootContext()->setContextProperty("ParticleBudget", particleBudget);
+    }
+    GameManager manager(view.data());
+    manager.setMaxPlayers(maxPlayers(parser));
+
+    if (view) {
+        PerformanceMonitor *performanceMonitor = new PerformanceMonitor(&manager, view.data(), particleBudget);
+        view->rootContext()->setContextProperty("PerformanceMonitor", performanceMonitor);
+
+        IdleMonitor *idleMonitor = new IdleMonitor(&manager, view.data());
+        view->rootContext()->setContextProperty("IdleMonitor", idleMonitor);
+    }
+
+    int port = DEFAULT_PORT;
+    if (parser.isSet(ARGUMENT_PORT)) {
+        bool ok;
+        port = parser.value(ARGUMENT_PORT).toInt(&ok);
+        if (!ok || port < 1 || port > 65535) {
+            parser.showHelp(-1);
+        }
+    }
+    manager.setPrintStatus(parser.isSet(ARGUMENT_STATUS));
+    if (!manager.listen(port) && headless) {
+        return 1;
+    }
+
+    if (parser.isSet(ARGUMENT_RESULTS)) {
+        manager.setResultsFileName(parser.value(ARGUMENT_RESULTS));
+    }
+
+    if (parser.isSet(ARGUMENT_ROUND_RESULTS)) {
+        manager.setRoundResultsFileName(parser.value(ARGUMENT_ROUND_RESULTS));
+    }
 
     if (parser.isSet(ARGUMENT_ROUNDS)) {
         int rounds = parser.value(ARGUMENT_ROUNDS).toInt();
@@ -81,16 +682,41 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (parser.isSet(ARGUMENT_SEED)) {
+        bool ok;
+        quint64 seed = parser.value(ARGUMENT_SEED).toULongLong(&ok);
+        if (!ok) {
+            parser.showHelp(-1);
+        }
+        manager.setSeed(seed);
+    }
+
+    if (parser.isSet(ARGUMENT_DIGEST)) {
+        manager.setSendDigest(true);
+    }
+
+    manager.setInterestRadius(interestRadius(parser));
+
+    if (parser.isSet(ARGUMENT_RECORD)) {
+        manager.setRecordingDirectory(parser.value(ARGUMENT_RECORD));
+    }
+
+    if (parser.isSet(ARGUMENT_REPLAY)) {
+        if (!manager.loadReplay(parser.value(ARGUMENT_REPLAY))) {
+            return 1;
+        }
+    }
+
     if (parser.isSet(ARGUMENT_START_AT)) {
         int startAtPlayers = parser.value(ARGUMENT_START_AT).toInt();
-        if (startAtPlayers < 1 || startAtPlayers > 4) {
+        if (startAtPlayers < 1 || startAtPlayers > manager.maxPlayerCount()) {
             parser.showHelp(-1);
         }
 
         manager.setCountdownDuration(0);
 
         QObject::connect(&manager, &GameManager::playersChanged, [&]{
-            if (manager.players().count() >= startAtPlayers) {
+            if (manager.playerCount() >= startAtPlayers) {
                 manager.startGame();
             }
         });
@@ -106,19 +732,21 @@ int main(int argc, char *argv[])
 
     if (parser.isSet(ARGUMENT_QUIT_ON_FINISH)) {
         QObject::connect(&manager, &GameManager::roundsPlayedChanged, [&]{
-            if (manager.roundsPlayed() >= MAX_ROUNDS) {
-                app.quit();
+            if (manager.roundsPlayed() >= manager.maxRounds()) {
+                app->quit();
             }
         });
     }
 
-    view.setSource(QUrl("qrc:/qml/main.qml"));
+    if (view) {
+        view->setSource(QUrl("qrc:/qml/main.qml"));
 
-    if (parser.isSet(ARGUMENT_FULLSCREEN)) {
-        view.showFullScreen();
-    } else {
-        view.show();
+        if (parser.isSet(ARGUMENT_FULLSCREEN)) {
+            view->showFullScreen();
+        } else {
+            view->show();
+        }
     }
 
-    return app.exec();
+    return app->exec();
 }
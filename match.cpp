@@ -0,0 +1,74 @@
+#include "match.h"
+
+Match::Match(const MatchConfig &config) :
+    m_config(config),
+    m_valid(true),
+    m_world(config.seed)
+{
+    const int shipCount = config.bots.size();
+
+    m_result.seed = config.seed;
+    m_result.roundsPlayed = 0;
+    m_result.bots = config.bots;
+    m_result.wins.assign(shipCount, 0);
+    m_result.scores.assign(shipCount, 0);
+    m_result.energy.assign(shipCount, 0);
+
+    // Give each bot its own random stream, so they don't depend on each other
+    for (int i=0; i<shipCount; i++) {
+        Bot *bot = createBot(config.bots[i], config.seed ^ (0x9e3779b97f4a7c15ULL * (i + 1)));
+        if (!bot) {
+            m_valid = false;
+        }
+        m_bots.emplace_back(bot);
+    }
+
+    m_commands.resize(shipCount, CommandNone);
+
+    if (shipCount == 0 || !m_valid) {
+        m_result.roundsPlayed = m_config.rounds;
+        return;
+    }
+
+    m_world.setShipCount(shipCount);
+    m_world.startRound();
+}
+
+bool Match::run(int tickBudget)
+{
+    while (!isFinished() && tickBudget-- > 0) {
+        const std::vector<ShipState> &ships = m_world.ships();
+        for (size_t i=0; i<m_bots.size(); i++) {
+            m_commands[i] = ships[i].alive ? m_bots[i]->command(m_world, i) : uint8_t(CommandNone);
+        }
+
+        const bool roundOver = m_world.step(m_commands.data());
+
+        for (const Hit &hit : m_world.hits()) {
+            m_result.scores[hit.owner]++;
+        }
+
+        if (roundOver || m_world.tick() >= m_config.maxTicks) {
+            endRound();
+        }
+    }
+
+    return isFinished();
+}
+
+void Match::endRound()
+{
+    const std::vector<ShipState> &ships = m_world.ships();
+    for (size_t i=0; i<ships.size(); i++) {
+        if (ships[i].alive) {
+            m_result.wins[i]++;
+        }
+        m_result.energy[i] = ships[i].energy;
+    }
+
+    m_result.roundsPlayed++;
+
+    if (!isFinished()) {
+        m_world.startRound();
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include "world.h"
+#include "bot.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+struct MatchConfig
+{
+    uint64_t seed;
+    int rounds;
+    int maxTicks; // Per round, in case nobody manages to die
+    std::vector<std::string> bots; // Bot types, see createBot()
+};
+
+struct MatchResult
+{
+    uint64_t seed;
+    int roundsPlayed;
+    std::vector<std::string> bots;
+    std::vector<int> wins;
+    std::vector<int> scores; // Hits on the others
+    std::vector<int> energy; // Left at the end of the last round
+};
+
+// A whole match between built in bots, without any timers or Qt, scored
+// the same way as GameManager does.
+class Match
+{
+public:
+    explicit Match(const MatchConfig &config);
+
+    // Runs at most tickBudget ticks, so long matches can be split up.
+    // Returns true when all rounds have been played.
+    bool run(int tickBudget);
+
+    bool isFinished() const { return m_result.roundsPlayed >= m_config.rounds; }
+    const MatchResult &result() const { return m_result; }
+
+    // False if one of the bot types doesn't exist
+    bool isValid() const { return m_valid; }
+
+private:
+    void endRound();
+
+    MatchConfig m_config;
+    MatchResult m_result;
+    bool m_valid;
+
+    World m_world;
+    std::vector<std::unique_ptr<Bot>> m_bots;
+    std::vector<uint8_t> m_commands;
+};
+
+#endif // MATCH_H
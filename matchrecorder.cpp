@@ -0,0 +1,148 @@
+#include "matchrecorder.h"
+
+#include "player.h"
+#include "world.h"
+#include "parameters.h"
+
+#include <QDebug>
+
+#include <cstring>
+
+MatchRecorder::MatchRecorder(QObject *parent) : QObject(parent),
+    m_frame(0),
+    m_offset(0)
+{
+}
+
+void MatchRecorder::start(const QString &fileName, quint64 seed, int tickInterval, const QList<Player*> &players)
+{
+    RecordingHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = RECORDING_MAGIC;
+    header.version = RECORDING_VERSION;
+    header.seed = seed;
+    header.tickInterval = tickInterval;
+    header.playerCount = players.count();
+
+    header.parameters.missileMaxSpeed = MISSILE_MAX_SPEED;
+    header.parameters.accelerationForce = ACCELERATION_FORCE;
+    header.parameters.accelerationCost = ACCELERATION_COST;
+    header.parameters.missileCost = MISSILE_COST;
+    header.parameters.seekingMissileCost = SEEKING_MISSILE_COST;
+    header.parameters.mineCost = MINE_COST;
+    header.parameters.missileDamage = MISSILE_DAMAGE;
+    header.parameters.rotateCost = ROTATE_COST;
+    header.parameters.rotateAmount = ROTATE_AMOUNT;
+    header.parameters.startEnergy = START_ENERGY;
+    header.parameters.maxPlayers = MAX_PLAYERS;
+    header.parameters.maxRounds = MAX_ROUNDS;
+    header.parameters.seekingRetargetInterval = SEEKING_RETARGET_INTERVAL;
+
+    QByteArray data(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (Player *player : players) {
+        RecordedName name;
+        memset(&name, 0, sizeof(name));
+
+        const QByteArray utf8Name = player->name().toUtf8().left(RECORDING_NAME_LENGTH - 1);
+        memcpy(name.name, utf8Name.constData(), utf8Name.size());
+
+        data.append(reinterpret_cast<const char*>(&name), sizeof(name));
+    }
+
+    m_frame = 0;
+    m_offset = data.size();
+    m_keyframes.clear();
+    m_writer.open(fileName);
+    m_writer.write(data);
+
+    qDebug() << "Recording match to" << fileName;
+}
+
+void MatchRecorder::recordTick(int round, const World &world, quint64 digest)
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    if (m_frame % KEYFRAME_INTERVAL == 0) {
+        m_keyframes.append(m_offset);
+    }
+
+    FrameHeader frameHeader;
+    memset(&frameHeader, 0, sizeof(frameHeader));
+    frameHeader.frame = m_frame++;
+    const std::vector<ShipState> &ships = world.ships();
+    const std::vector<MissileState> &missiles = world.missiles();
+    const std::vector<uint8_t> &commands = world.appliedCommands();
+
+    frameHeader.round = round;
+    frameHeader.tick = world.tick() - 1; // The tick that was just stepped
+    frameHeader.playerCount = ships.size();
+    frameHeader.missileCount = missiles.size();
+    frameHeader.digest = digest;
+
+    QByteArray data;
+    data.reserve(sizeof(FrameHeader) + ships.size() * sizeof(PlayerRecord) + missiles.size() * sizeof(MissileRecord));
+    data.append(reinterpret_cast<const char*>(&frameHeader), sizeof(frameHeader));
+
+    for (size_t i=0; i<ships.size(); i++) {
+        const ShipState &ship = ships[i];
+
+        PlayerRecord record;
+        record.x = ship.x;
+        record.y = ship.y;
+        record.velocityX = ship.velocityX;
+        record.velocityY = ship.velocityY;
+        record.energy = ship.energy;
+        record.rotation = ship.rotation;
+        record.alive = ship.alive;
+        record.command = (i < commands.size()) ? commands[i] : quint8(CommandNone);
+
+        data.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    for (const MissileState &missile : missiles) {
+        MissileRecord record;
+        record.id = missile.id;
+        record.x = missile.x;
+        record.y = missile.y;
+        record.velocityX = missile.velocityX;
+        record.velocityY = missile.velocityY;
+        record.rotation = missile.rotation;
+        record.energy = missile.energy;
+        record.owner = missile.owner;
+        record.type = missile.type;
+        record.reserved = 0;
+
+        data.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    m_offset += data.size();
+    m_writer.write(data);
+}
+
+void MatchRecorder::finish()
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    QByteArray data;
+    for (quint64 offset : m_keyframes) {
+        RecordingIndexEntry entry;
+        entry.offset = offset;
+        data.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    RecordingTrailer trailer;
+    trailer.indexOffset = m_offset;
+    trailer.frameCount = m_frame;
+    trailer.keyframeInterval = KEYFRAME_INTERVAL;
+    trailer.keyframeCount = m_keyframes.count();
+    trailer.magic = RECORDING_TRAILER_MAGIC;
+    data.append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+
+    m_writer.write(data);
+    m_writer.close();
+}
@@ -0,0 +1,35 @@
+#ifndef MATCHRECORDER_H
+#define MATCHRECORDER_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QString>
+
+#include "asyncfilewriter.h"
+#include "recording.h"
+
+class Player;
+class World;
+
+class MatchRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MatchRecorder(QObject *parent = 0);
+
+    void start(const QString &fileName, quint64 seed, int tickInterval, const QList<Player*> &players);
+    void recordTick(int round, const World &world, quint64 digest);
+    void finish();
+
+    bool isRecording() { return m_writer.isOpen(); }
+
+private:
+    AsyncFileWriter m_writer;
+    quint32 m_frame;
+    quint64 m_offset;
+    QVector<quint64> m_keyframes;
+};
+
+#endif // MATCHRECORDER_H
@@ -0,0 +1,128 @@
+#include "matchrunner.h"
+
+#include <thread>
+
+// Ticks to play of a match before looking at the queues again
+#define TICKS_PER_SLICE 500
+
+MatchRunner::MatchRunner(int threadCount) :
+    m_threadCount(threadCount),
+    m_remaining(0),
+    m_workGeneration(0)
+{
+    if (m_threadCount <= 0) {
+        m_threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<MatchResult> MatchRunner::run(const std::vector<MatchConfig> &configs)
+{
+    m_matches.clear();
+    m_queues.clear();
+
+    for (int i=0; i<m_threadCount; i++) {
+        m_queues.emplace_back(new WorkQueue);
+    }
+
+    // Deal out the matches, the stealing evens it out later
+    for (size_t i=0; i<configs.size(); i++) {
+        m_matches.emplace_back(new Match(configs[i]));
+        m_queues[i % m_threadCount]->matches.push_back(i);
+    }
+    m_remaining = configs.size();
+
+    std::vector<std::thread> threads;
+    for (int i=1; i<m_threadCount; i++) {
+        threads.emplace_back(&MatchRunner::work, this, i);
+    }
+    work(0);
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<MatchResult> results;
+    for (const std::unique_ptr<Match> &match : m_matches) {
+        results.push_back(match->result());
+    }
+
+    m_matches.clear();
+    m_queues.clear();
+
+    return results;
+}
+
+void MatchRunner::work(int worker)
+{
+    while (m_remaining > 0) {
+        // Look before trying, so nothing queued in between goes unnoticed
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            generation = m_workGeneration;
+        }
+
+        int index;
+        if (!takeMatch(worker, &index)) {
+            // Everything left is being played by other threads
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_workChanged.wait(lock, [this, generation]() {
+                return m_workGeneration != generation || m_remaining == 0;
+            });
+            continue;
+        }
+
+        Match *match = m_matches[index].get();
+        if (!match->run(TICKS_PER_SLICE)) {
+            {
+                WorkQueue *queue = m_queues[worker].get();
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                queue->matches.push_back(index);
+            }
+            notifyWorkers();
+            continue;
+        }
+
+        if (m_finishedCallback) {
+            m_finishedCallback(index, match->result());
+        }
+        m_remaining--;
+        notifyWorkers();
+    }
+}
+
+void MatchRunner::notifyWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_workGeneration++;
+    }
+    m_workChanged.notify_all();
+}
+
+bool MatchRunner::takeMatch(int worker, int *match)
+{
+    // Our own newest first, it is probably still in the cache
+    {
+        WorkQueue *queue = m_queues[worker].get();
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->matches.empty()) {
+            *match = queue->matches.back();
+            queue->matches.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest from someone else
+    for (int i=1; i<m_threadCount; i++) {
+        WorkQueue *queue = m_queues[(worker + i) % m_threadCount].get();
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->matches.empty()) {
+            *match = queue->matches.front();
+            queue->matches.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,60 @@
+#ifndef MATCHRUNNER_H
+#define MATCHRUNNER_H
+
+#include "match.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Plays many matches at the same time on a fixed number of threads.
+//
+// Matches are played a slice of ticks at a time. Each thread keeps the
+// matches it is working on in its own queue, and when that runs dry it
+// steals from the others, so a few long matches don't leave threads idle.
+// The results only depend on the configs, not on how the work got spread.
+class MatchRunner
+{
+public:
+    // threadCount 0 means one per core
+    explicit MatchRunner(int threadCount = 0);
+
+    int threadCount() const { return m_threadCount; }
+
+    // Called from the worker threads as each match finishes
+    void setFinishedCallback(const std::function<void(int index, const MatchResult &result)> &callback) { m_finishedCallback = callback; }
+
+    // Blocks until all matches are played, results are in the same order as configs
+    std::vector<MatchResult> run(const std::vector<MatchConfig> &configs);
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<int> matches;
+    };
+
+    void work(int worker);
+    bool takeMatch(int worker, int *match);
+
+    // Wakes up the threads waiting for something to do
+    void notifyWorkers();
+
+    int m_threadCount;
+    std::function<void(int, const MatchResult&)> m_finishedCallback;
+
+    std::vector<std::unique_ptr<Match>> m_matches;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::atomic<int> m_remaining;
+
+    // Threads with nothing to play sleep on this until a match is queued again or finishes
+    std::mutex m_idleMutex;
+    std::condition_variable m_workChanged;
+    uint64_t m_workGeneration;
+};
+
+#endif // MATCHRUNNER_H
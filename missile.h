@@ -22,17 +22,26 @@ public:
         Seeking
     };
 
-    explicit Missile(Type type, QPointF startPosition, int startRotation, int owner, QObject *parent = 0);
+    // The movement is done by World, this just mirrors it, so set the rest with setState()
+    explicit Missile(Type type, int owner, quint32 id, QObject *parent = 0);
+
+    quint32 id() { return m_id; }
 
 
     QPointF position() { return m_position; }
 
     int rotation() { return (m_rotation * 360 / (M_PI * 2)); }
+    qreal angle() { return m_rotation; }
     void setRotation(qreal rotation);
 
-    void doMove();
+    qreal velocityX() { return m_velocityX; }
+    qreal velocityY() { return m_velocityY; }
+
     int energy() { return m_energy; }
 
+    // Sets everything that moves in one go
+    void setState(QPointF position, qreal velocityX, qreal velocityY, qreal rotation, int energy);
+
     bool isAlive() { return m_alive; }
     Type type() { return m_type; }
 
@@ -56,6 +65,7 @@ private:
     int m_energy;
     bool m_alive;
     int m_owner;
+    quint32 m_id;
 };
 
 #endif // MISSILE_H
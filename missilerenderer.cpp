@@ -0,0 +1,204 @@
+#include "missilerenderer.h"
+
+#include "gamemanager.h"
+#include "atlasnode.h"
+
+#include <QColor>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QTransform>
+#include <QVector>
+
+namespace {
+
+enum Sprite {
+    SpriteFull,
+    SpriteHalf,
+    SpriteEmpty,
+    SpriteCount
+};
+
+Sprite spriteForEnergy(int energy)
+{
+    if (energy < 40) {
+        return SpriteEmpty;
+    } else if (energy < 75) {
+        return SpriteHalf;
+    } else {
+        return SpriteFull;
+    }
+}
+
+}
+
+MissileRenderer::MissileRenderer(QQuickItem *parent) : QQuickItem(parent),
+    m_colorCount(1),
+    m_colorColumns(1),
+    m_atlasChanged(true)
+{
+    setFlag(ItemHasContents, true);
+    createAtlas();
+}
+
+QObject *MissileRenderer::game() const
+{
+    return m_game.data();
+}
+
+void MissileRenderer::setGame(QObject *game)
+{
+    GameManager *manager = qobject_cast<GameManager*>(game);
+    if (manager == m_game) {
+        return;
+    }
+
+    if (m_game) {
+        disconnect(m_game, &GameManager::frameAdvanced, this, &MissileRenderer::onFrameAdvanced);
+    }
+
+    m_game = manager;
+
+    if (m_game) {
+        connect(m_game, &GameManager::frameAdvanced, this, &MissileRenderer::onFrameAdvanced);
+    }
+
+    emit gameChanged();
+    onFrameAdvanced();
+}
+
+void MissileRenderer::setColors(const QVariantList &colors)
+{
+    if (colors == m_colors) {
+        return;
+    }
+
+    m_colors = colors;
+    createAtlas();
+    emit colorsChanged();
+    update();
+}
+
+void MissileRenderer::onFrameAdvanced()
+{
+    if (m_game) {
+        m_missiles = m_game->displayedMissiles();
+    } else {
+        m_missiles.clear();
+    }
+    update();
+}
+
+void MissileRenderer::createAtlas()
+{
+    static const char *fileNames[SpriteCount] = {
+        ":/sprites/missile-full.png",
+        ":/sprites/missile-half.png",
+        ":/sprites/missile-empty.png"
+    };
+
+    QImage sprites[SpriteCount];
+    m_spriteSize = QSize(1, 1);
+    for (int i=0; i<SpriteCount; i++) {
+        sprites[i] = QImage(fileNames[i]).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        m_spriteSize = m_spriteSize.expandedTo(sprites[i].size());
+    }
+
+    QList<QColor> colors;
+    for (const QVariant &color : m_colors) {
+        colors.append(color.value<QColor>());
+    }
+    if (colors.isEmpty()) {
+        colors.append(Qt::white);
+    }
+
+    const QSize blockSize(m_spriteSize.width() * SpriteCount, m_spriteSize.height());
+    m_colorCount = colors.count();
+    m_colorColumns = AtlasNode::gridColumns(m_colorCount, blockSize);
+    const int colorRows = (m_colorCount + m_colorColumns - 1) / m_colorColumns;
+
+    m_atlas = QImage(blockSize.width() * m_colorColumns, blockSize.height() * colorRows, QImage::Format_ARGB32_Premultiplied);
+    m_atlas.fill(Qt::transparent);
+
+    QPainter painter(&m_atlas);
+    for (int color=0; color<m_colorCount; color++) {
+        const QPoint blockPosition((color % m_colorColumns) * blockSize.width(), (color / m_colorColumns) * blockSize.height());
+        for (int column=0; column<SpriteCount; column++) {
+            const QRect cell(blockPosition + QPoint(column * m_spriteSize.width(), 0), m_spriteSize);
+
+            // Same as the ColorOverlay the sprites used to have: the shape of the sprite, in the player's colour
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.drawImage(cell.topLeft(), sprites[column]);
+            painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+            painter.fillRect(cell, colors[color]);
+        }
+    }
+    painter.end();
+
+    m_atlasChanged = true;
+}
+
+QRect MissileRenderer::spriteRect(const MissileState &missile) const
+{
+    const int color = missile.owner % m_colorCount;
+    const int column = (color % m_colorColumns) * SpriteCount + spriteForEnergy(missile.energy);
+    return QRect(QPoint(column * m_spriteSize.width(), (color / m_colorColumns) * m_spriteSize.height()), m_spriteSize);
+}
+
+QSGNode *MissileRenderer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    // Same size as the sprites used to be
+    const qreal size = qMin(width(), height()) / 30;
+
+    if (PainterNode::isNeeded(window())) {
+        PainterNode *node = oldNode ? static_cast<PainterNode*>(oldNode) : new PainterNode(this);
+
+        const std::vector<MissileState> missiles = m_missiles;
+        const QImage atlas = m_atlas;
+        const qreal itemWidth = width(), itemHeight = height();
+        QVector<QRect> sources;
+        sources.reserve(int(missiles.size()));
+        for (const MissileState &missile : missiles) {
+            sources.append(spriteRect(missile));
+        }
+
+        node->setPaint([=](QPainter *painter) {
+            for (size_t i=0; i<missiles.size(); i++) {
+                const MissileState &missile = missiles[i];
+                const QPointF center(itemWidth / 2 + missile.x * itemWidth / 2, itemHeight / 2 + missile.y * itemHeight / 2);
+                PainterNode::drawRotated(painter, atlas, sources[int(i)], center, size, missile.rotation + M_PI / 2);
+            }
+        });
+
+        node->markDirty(QSGNode::DirtyMaterial);
+        return node;
+    }
+
+    AtlasNode *node = static_cast<AtlasNode*>(oldNode);
+    if (!node) {
+        node = new AtlasNode;
+        m_atlasChanged = true;
+    }
+
+    if (m_atlasChanged) {
+        node->setTexture(window()->createTextureFromImage(m_atlas));
+        m_atlasChanged = false;
+    }
+
+    const QTransform toTexture = QTransform::fromScale(1.0 / m_atlas.width(), 1.0 / m_atlas.height());
+
+    node->allocateQuads(int(m_missiles.size()));
+
+    QPointF corners[4];
+    for (size_t i=0; i<m_missiles.size(); i++) {
+        const MissileState &missile = m_missiles[i];
+        const QPointF center(width() / 2 + missile.x * width() / 2, height() / 2 + missile.y * height() / 2);
+
+        // The sprites point up, the rotation is from the x axis
+        AtlasNode::rotatedSquare(center, size, missile.rotation + M_PI / 2, corners);
+
+        node->setQuad(int(i), corners, toTexture.mapRect(QRectF(spriteRect(missile))));
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
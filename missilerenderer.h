@@ -0,0 +1,61 @@
+#ifndef MISSILERENDERER_H
+#define MISSILERENDERER_H
+
+#include <QQuickItem>
+#include <QPointer>
+#include <QVariantList>
+#include <QImage>
+
+#include "world.h"
+
+class GameManager;
+
+// Draws all the missiles in one scene graph node, instead of one QML item
+// each, with the sprites for every player's colour packed into one texture.
+// Place it over the whole game area.
+class MissileRenderer : public QQuickItem
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QObject *game READ game WRITE setGame NOTIFY gameChanged)
+    Q_PROPERTY(QVariantList colors READ colors WRITE setColors NOTIFY colorsChanged)
+
+public:
+    explicit MissileRenderer(QQuickItem *parent = nullptr);
+
+    QObject *game() const;
+    void setGame(QObject *game);
+
+    // One colour per player, the sprites are tinted with it
+    QVariantList colors() const { return m_colors; }
+    void setColors(const QVariantList &colors);
+
+signals:
+    void gameChanged();
+    void colorsChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override;
+
+private slots:
+    void onFrameAdvanced();
+
+private:
+    void createAtlas();
+    QRect spriteRect(const MissileState &missile) const;
+
+    QPointer<GameManager> m_game;
+    QVariantList m_colors;
+
+    // Copy of where the missiles are in this frame, so we can draw them while the game goes on
+    std::vector<MissileState> m_missiles;
+
+    // The sprites for each colour side by side (full, half, empty), in a grid of colours
+    QImage m_atlas;
+    QSize m_spriteSize;
+    int m_colorCount;
+    int m_colorColumns;
+    bool m_atlasChanged;
+};
+
+#endif // MISSILERENDERER_H
@@ -6,7 +6,9 @@
 #include "player.h"
 
 NetworkClient::NetworkClient(QTcpSocket *socket) :
-    QObject(socket), m_socket(socket)
+    QObject(socket), m_socket(socket), m_waitingForCommand(false),
+    m_lastLatency(0), m_bytesSent(0), m_bytesReceived(0),
+    m_interestRadius(-1), m_interestLimit(0)
 {
     socket->open(QIODevice::ReadWrite);
     m_name = m_socket->peerAddress().toString();
@@ -20,6 +22,13 @@ QString NetworkClient::remoteName()
     return m_name;
 }
 
+QVector<qint64> NetworkClient::takeLatencies()
+{
+    QVector<qint64> latencies;
+    latencies.swap(m_latencies);
+    return latencies;
+}
+
 void NetworkClient::kick()
 {
     m_socket->disconnectFromHost();
@@ -31,7 +40,10 @@ void NetworkClient::sendString(QByteArray string)
         return;
     }
 
-    m_socket->write(string + '\n');
+    const qint64 written = m_socket->write(string + '\n');
+    if (written > 0) {
+        m_bytesSent += written;
+    }
 }
 
 void NetworkClient::sendDead()
@@ -58,11 +70,15 @@ void NetworkClient::sendState(const QJsonObject gameState)
     stateObject["gamestate"] = gameState;
     QJsonDocument packet(stateObject);
     sendString(packet.toJson(QJsonDocument::Compact));
+
+    m_stateSent.start();
+    m_waitingForCommand = true;
 }
 
 void NetworkClient::dataReceived()
 {
     QByteArray data = m_socket->readAll();
+    m_bytesReceived += data.size();
 
 
     QList<QByteArray> lines = data.split('\n');
@@ -80,6 +96,24 @@ void NetworkClient::dataReceived()
             continue;
         }
 
+        // INTEREST <radius> [<count>]
+        if (line.startsWith("INTEREST ")) {
+            QList<QByteArray> splitLine = line.trimmed().split(' ');
+            bool ok;
+            const double radius = splitLine.value(1).toDouble(&ok);
+            if (!ok || !qIsFinite(radius)) continue;
+            // Nothing is further away than 2, and anything bigger only costs us time
+            m_interestRadius = qBound(0.0, radius, 2.0);
+            m_interestLimit = qMax(splitLine.value(2).toInt(), 0);
+            continue;
+        }
+
+        if (m_waitingForCommand) {
+            m_lastLatency = m_stateSent.nsecsElapsed() / 1000;
+            m_latencies.append(m_lastLatency);
+            m_waitingForCommand = false;
+        }
+
         emit commandReceived(QString::fromLatin1(line.trimmed()));
     }
 }
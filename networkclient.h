@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QPoint>
 #include <QJsonObject>
+#include <QElapsedTimer>
+#include <QVector>
 
 class QTcpSocket;
 class Player;
@@ -22,6 +24,22 @@ public:
     void sendDead();
     void kick();
 
+    // How long, in microseconds, the client took to answer each state update since last time
+    QVector<qint64> takeLatencies();
+
+    // How long the client took to answer the last state update it answered, in microseconds
+    qint64 lastLatency() const { return m_lastLatency; }
+
+    // Since the client connected
+    quint64 bytesSent() const { return m_bytesSent; }
+    quint64 bytesReceived() const { return m_bytesReceived; }
+
+    // What the client asked to get in the state updates: everything within the radius, and at
+    // most the limit nearest players and missiles when it's above 0. The radius is below 0 until
+    // the client asks, and 0 means everything.
+    double interestRadius() const { return m_interestRadius; }
+    int interestLimit() const { return m_interestLimit; }
+
 signals:
     void commandReceived(const QString command);
     void clientDisconnected();
@@ -35,6 +53,15 @@ private:
 
     QTcpSocket *m_socket;
     QString m_name;
+
+    QElapsedTimer m_stateSent;
+    bool m_waitingForCommand;
+    QVector<qint64> m_latencies;
+    qint64 m_lastLatency;
+    quint64 m_bytesSent;
+    quint64 m_bytesReceived;
+    double m_interestRadius;
+    int m_interestLimit;
 };
 
 #endif // NETWORKCLIENT_H
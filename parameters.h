@@ -2,6 +2,7 @@
 #define PARAMETERS_H
 
 #define DEFAULT_TICKINTERVAL 50
+#define DEFAULT_PORT 54321
 
 #define MISSILE_MAX_SPEED 0.05
 
@@ -14,12 +15,18 @@
 
 #define MISSILE_DAMAGE 10
 
+// How many ticks seeking missiles keep going for the same player before looking
+// for a closer one, they still look right away if their target dies
+#define SEEKING_RETARGET_INTERVAL 1
+
 #define ROTATE_COST 1
 #define ROTATE_AMOUNT 10
 
 #define START_ENERGY 1000
 
-#define MAX_PLAYERS 4
+// Games have up to DEFAULT_MAX_PLAYERS players, unless asked for more, up to MAX_PLAYERS
+#define DEFAULT_MAX_PLAYERS 4
+#define MAX_PLAYERS 256
 #define MAX_ROUNDS 4
 
 #endif // PARAMETERS_H
@@ -0,0 +1,78 @@
+#include "particlebudget.h"
+
+#include <QQuickWindow>
+
+#define PARTICLE_BUDGET_MIN_SCALE 0.05
+
+// Longer than this between frames means nothing was animating, not that the frame was slow
+#define PARTICLE_BUDGET_IDLE_TIME 250
+
+// Frames to wait after changing the scale, so the new frame times can show up in the average
+#define PARTICLE_BUDGET_SETTLE_FRAMES 10
+
+ParticleBudget::ParticleBudget(QQuickWindow *window) : QObject(window),
+    m_frameTime(0),
+    m_scale(1),
+    m_targetFps(60),
+    m_framesSinceChange(0),
+    m_adaptive(true)
+{
+    connect(window, &QQuickWindow::afterAnimating, this, &ParticleBudget::onFrame);
+}
+
+void ParticleBudget::setTargetFps(int fps)
+{
+    if (fps == m_targetFps || fps <= 0) {
+        return;
+    }
+
+    m_targetFps = fps;
+    emit targetFpsChanged();
+}
+
+void ParticleBudget::setAdaptive(bool adaptive)
+{
+    m_adaptive = adaptive;
+
+    if (!m_adaptive && m_scale != 1) {
+        m_scale = 1;
+        emit scaleChanged();
+    }
+}
+
+void ParticleBudget::onFrame()
+{
+    if (!m_frameTimer.isValid()) {
+        m_frameTimer.start();
+        return;
+    }
+
+    const qreal elapsed = m_frameTimer.nsecsElapsed() / 1000000.0;
+    m_frameTimer.restart();
+    if (elapsed > PARTICLE_BUDGET_IDLE_TIME) {
+        return;
+    }
+
+    // Average over roughly the last 16 frames
+    m_frameTime = m_frameTime > 0 ? m_frameTime + (elapsed - m_frameTime) / 16 : elapsed;
+    emit frameTimeChanged();
+
+    if (!m_adaptive || ++m_framesSinceChange < PARTICLE_BUDGET_SETTLE_FRAMES) {
+        return;
+    }
+
+    // Cut quickly when we're too slow, and grow back slowly so we don't oscillate
+    const qreal target = 1000.0 / m_targetFps;
+    qreal scale = m_scale;
+    if (m_frameTime > target * 1.1) {
+        scale = qMax<qreal>(PARTICLE_BUDGET_MIN_SCALE, m_scale * 0.8);
+    } else if (m_frameTime < target * 1.02) {
+        scale = qMin<qreal>(1, m_scale * 1.05);
+    }
+
+    if (!qFuzzyCompare(scale, m_scale)) {
+        m_scale = scale;
+        m_framesSinceChange = 0;
+        emit scaleChanged();
+    }
+}
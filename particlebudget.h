@@ -0,0 +1,52 @@
+#ifndef PARTICLEBUDGET_H
+#define PARTICLEBUDGET_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QQuickWindow;
+
+// Watches how long the frames take, and scales down how many particles the
+// emitters make until we hold the target frame rate, and back up when there's
+// room again. The emitters multiply their rates and bursts by scale.
+class ParticleBudget : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(qreal scale READ scale NOTIFY scaleChanged)
+    Q_PROPERTY(qreal frameTime READ frameTime NOTIFY frameTimeChanged)
+    Q_PROPERTY(int targetFps READ targetFps WRITE setTargetFps NOTIFY targetFpsChanged)
+
+public:
+    explicit ParticleBudget(QQuickWindow *window);
+
+    // From 0.05 to 1, 1 is the full number of particles
+    qreal scale() const { return m_scale; }
+
+    // Average milliseconds per frame lately
+    qreal frameTime() const { return m_frameTime; }
+
+    int targetFps() const { return m_targetFps; }
+    void setTargetFps(int fps);
+
+    // When not adaptive the scale stays at 1, like when every frame may take as long as it needs
+    void setAdaptive(bool adaptive);
+
+signals:
+    void scaleChanged();
+    void frameTimeChanged();
+    void targetFpsChanged();
+
+private slots:
+    void onFrame();
+
+private:
+    QElapsedTimer m_frameTimer;
+    qreal m_frameTime;
+    qreal m_scale;
+    int m_targetFps;
+    int m_framesSinceChange;
+    bool m_adaptive;
+};
+
+#endif // PARTICLEBUDGET_H
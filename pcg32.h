@@ -0,0 +1,52 @@
+#ifndef PCG32_H
+#define PCG32_H
+
+#include <cstdint>
+
+// PCG32 (XSH RR) random number generator, see http://www.pcg-random.org/
+// Every match owns one, so the same seed gives the same match.
+class Pcg32
+{
+public:
+    explicit Pcg32(uint64_t seed = 0, uint64_t stream = 54)
+    {
+        setSeed(seed, stream);
+    }
+
+    void setSeed(uint64_t seed, uint64_t stream = 54)
+    {
+        m_state = 0;
+        m_increment = (stream << 1u) | 1u;
+        next();
+        m_state += seed;
+        next();
+    }
+
+    uint32_t next()
+    {
+        const uint64_t oldState = m_state;
+        m_state = oldState * 6364136223846793005ULL + m_increment;
+
+        const uint32_t xorShifted = uint32_t(((oldState >> 18u) ^ oldState) >> 27u);
+        const uint32_t rotation = uint32_t(oldState >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+    }
+
+    // Unbiased number in [0, bound)
+    uint32_t bounded(uint32_t bound)
+    {
+        const uint32_t threshold = (0x100000000ULL - bound) % bound;
+        for (;;) {
+            const uint32_t number = next();
+            if (number >= threshold) {
+                return number % bound;
+            }
+        }
+    }
+
+private:
+    uint64_t m_state;
+    uint64_t m_increment;
+};
+
+#endif // PCG32_H
@@ -0,0 +1,124 @@
+#include "performancemonitor.h"
+
+#include "networkclient.h"
+#include "particlebudget.h"
+#include "player.h"
+
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QVariantMap>
+
+// Four times a second
+#define PERFORMANCE_SAMPLE_INTERVAL 250
+
+PerformanceMonitor::PerformanceMonitor(GameManager *game, QQuickWindow *window, ParticleBudget *particleBudget) : QObject(window),
+    m_game(game),
+    m_window(window),
+    m_particleBudget(particleBudget),
+    m_lastTimings(),
+    m_tickRate(0),
+    m_stepTime(0),
+    m_syncTime(0),
+    m_sendTime(0),
+    m_itemCount(0),
+    m_particleCount(0)
+{
+    m_timer.setInterval(PERFORMANCE_SAMPLE_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &PerformanceMonitor::sample);
+}
+
+void PerformanceMonitor::setActive(bool active)
+{
+    if (active == isActive()) {
+        return;
+    }
+
+    if (active) {
+        // Start from now, so we don't average over the time we were hidden
+        m_sampleTimer.start();
+        m_lastTimings = m_game ? m_game->tickTimings() : TickTimings();
+        m_lastBotCounters.clear();
+        m_timer.start();
+        sample();
+    } else {
+        m_timer.stop();
+    }
+
+    emit activeChanged();
+}
+
+qreal PerformanceMonitor::frameTime() const
+{
+    return m_particleBudget ? m_particleBudget->frameTime() : 0;
+}
+
+int PerformanceMonitor::missileCount() const
+{
+    return m_game ? int(m_game->displayedMissiles().size()) : 0;
+}
+
+qreal PerformanceMonitor::particleScale() const
+{
+    return m_particleBudget ? m_particleBudget->scale() : 1;
+}
+
+void PerformanceMonitor::sample()
+{
+    if (!m_game) {
+        return;
+    }
+
+    const qreal seconds = qMax<qint64>(m_sampleTimer.restart(), 1) / 1000.0;
+
+    const TickTimings &timings = m_game->tickTimings();
+    const quint64 ticks = timings.ticks - m_lastTimings.ticks;
+    m_tickRate = ticks / seconds;
+    if (ticks > 0) {
+        m_stepTime = (timings.stepNanoseconds - m_lastTimings.stepNanoseconds) / 1000000.0 / ticks;
+        m_syncTime = (timings.syncNanoseconds - m_lastTimings.syncNanoseconds) / 1000000.0 / ticks;
+        m_sendTime = (timings.sendNanoseconds - m_lastTimings.sendNanoseconds) / 1000000.0 / ticks;
+    }
+    m_lastTimings = timings;
+
+    m_itemCount = 0;
+    m_particleCount = 0;
+    if (m_window->contentItem()) {
+        countItems(m_window->contentItem());
+    }
+
+    QHash<NetworkClient*, BotCounters> botCounters;
+    m_bots.clear();
+    for (Player *player : m_game->playerList()) {
+        NetworkClient *client = player->networkClient();
+        if (!client) {
+            continue;
+        }
+
+        const BotCounters counters = { client->bytesSent(), client->bytesReceived() };
+        const BotCounters last = m_lastBotCounters.value(client, counters);
+        botCounters[client] = counters;
+
+        QVariantMap bot;
+        bot["name"] = player->name();
+        bot["latency"] = client->lastLatency() / 1000.0;
+        bot["bytesIn"] = (counters.bytesReceived - last.bytesReceived) / seconds;
+        bot["bytesOut"] = (counters.bytesSent - last.bytesSent) / seconds;
+        m_bots.append(bot);
+    }
+    m_lastBotCounters = botCounters;
+
+    emit updated();
+}
+
+void PerformanceMonitor::countItems(QQuickItem *item)
+{
+    m_itemCount++;
+
+    if (item->inherits("QQuickParticleEmitter") && item->property("enabled").toBool()) {
+        m_particleCount += item->property("emitRate").toReal() * item->property("lifeSpan").toInt() / 1000;
+    }
+
+    for (QQuickItem *child : item->childItems()) {
+        countItems(child);
+    }
+}
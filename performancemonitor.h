@@ -0,0 +1,95 @@
+#ifndef PERFORMANCEMONITOR_H
+#define PERFORMANCEMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QVariantList>
+#include <QHash>
+
+#include "gamemanager.h"
+
+class QQuickWindow;
+class QQuickItem;
+class ParticleBudget;
+class NetworkClient;
+
+// Numbers for the performance overlay. While active, they are collected from
+// counters the game keeps anyway four times a second, and updated() is emitted.
+class PerformanceMonitor : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool active READ isActive WRITE setActive NOTIFY activeChanged)
+    Q_PROPERTY(qreal tickRate READ tickRate NOTIFY updated)
+    Q_PROPERTY(qreal stepTime READ stepTime NOTIFY updated)
+    Q_PROPERTY(qreal syncTime READ syncTime NOTIFY updated)
+    Q_PROPERTY(qreal sendTime READ sendTime NOTIFY updated)
+    Q_PROPERTY(qreal frameTime READ frameTime NOTIFY updated)
+    Q_PROPERTY(int missileCount READ missileCount NOTIFY updated)
+    Q_PROPERTY(int itemCount READ itemCount NOTIFY updated)
+    Q_PROPERTY(int particleCount READ particleCount NOTIFY updated)
+    Q_PROPERTY(qreal particleScale READ particleScale NOTIFY updated)
+    Q_PROPERTY(QVariantList bots READ bots NOTIFY updated)
+
+public:
+    PerformanceMonitor(GameManager *game, QQuickWindow *window, ParticleBudget *particleBudget);
+
+    bool isActive() const { return m_timer.isActive(); }
+    void setActive(bool active);
+
+    // Ticks per second
+    qreal tickRate() const { return m_tickRate; }
+
+    // Average milliseconds per tick spent in each part of it
+    qreal stepTime() const { return m_stepTime; }
+    qreal syncTime() const { return m_syncTime; }
+    qreal sendTime() const { return m_sendTime; }
+
+    qreal frameTime() const;
+    int missileCount() const;
+    int itemCount() const { return m_itemCount; }
+
+    // Estimated from the emitters' rates and particle life spans
+    int particleCount() const { return m_particleCount; }
+    qreal particleScale() const;
+
+    // For each connected bot: name, latency (ms), and bytesIn and bytesOut per second
+    QVariantList bots() const { return m_bots; }
+
+signals:
+    void activeChanged();
+    void updated();
+
+private slots:
+    void sample();
+
+private:
+    void countItems(QQuickItem *item);
+
+    struct BotCounters
+    {
+        quint64 bytesSent;
+        quint64 bytesReceived;
+    };
+
+    QPointer<GameManager> m_game;
+    QQuickWindow *m_window;
+    ParticleBudget *m_particleBudget;
+    QTimer m_timer;
+
+    QElapsedTimer m_sampleTimer;
+    TickTimings m_lastTimings;
+    QHash<NetworkClient*, BotCounters> m_lastBotCounters;
+
+    qreal m_tickRate;
+    qreal m_stepTime;
+    qreal m_syncTime;
+    qreal m_sendTime;
+    int m_itemCount;
+    int m_particleCount;
+    QVariantList m_bots;
+};
+
+#endif // PERFORMANCEMONITOR_H
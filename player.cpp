@@ -3,7 +3,6 @@
 #include "networkclient.h"
 #include "parameters.h"
 
-#include <qmath.h> // because windows sucks assss
 #include <QDebug>
 
 Player::Player(QObject *parent, int id, NetworkClient *networkClient) : QObject(parent),
@@ -12,6 +11,7 @@ Player::Player(QObject *parent, int id, NetworkClient *networkClient) : QObject(
     m_disconnected(false),
     m_alive(true),
     m_energy(START_ENERGY),
+    m_rotation(0),
     m_velocityX(0),
     m_velocityY(0),
     m_score(0),
@@ -26,7 +26,7 @@ Player::Player(QObject *parent, int id, NetworkClient *networkClient) : QObject(
         connect(networkClient, &NetworkClient::clientDisconnected, this, &Player::clientDisconnected);
     }
 
-    m_spritePath = "qrc:/sprites/players/player" + QString::number(id) + ".png";
+    m_spritePath = "image://players/" + QString::number(id);
     emit spritePathChanged();
 }
 
@@ -40,7 +40,7 @@ void Player::setId(int id)
     m_id = id;
     emit idChanged();
 
-    m_spritePath = "qrc:/sprites/players/player" + QString::number(id) + ".png";
+    m_spritePath = "image://players/" + QString::number(id);
     emit spritePathChanged();
 }
 
@@ -49,6 +49,16 @@ QString Player::lastCommand()
     return m_lastCommand;
 }
 
+void Player::setLastCommand(const QString &command)
+{
+    if (m_lastCommand == command) {
+        return;
+    }
+
+    m_lastCommand = command;
+    emit lastCommandChanged();
+}
+
 QString Player::command()
 {
     QString command = m_command;
@@ -131,14 +141,32 @@ void Player::setRotation(int rotation)
 
 void Player::setPosition(QPointF position)
 {
-    qreal velocityAngle = atan2(position.y(), position.x()) + M_PI_2;
-    m_velocityX = cos(velocityAngle) / 35.0;
-    m_velocityY = sin(velocityAngle) / 35.0;
+    m_position = position;
+    emit positionChanged();
+}
+
+void Player::setDisplayPosition(QPointF position)
+{
+    if (m_displayPosition == position) {
+        return;
+    }
+
+    m_displayPosition = position;
+    emit displayPositionChanged();
+}
 
+void Player::setState(QPointF position, qreal velocityX, qreal velocityY, int rotation, int energy, bool alive)
+{
     m_position = position;
     emit positionChanged();
 
-    setRotation(velocityAngle * 360 / (M_PI * 2.0));
+    m_velocityX = velocityX;
+    m_velocityY = velocityY;
+    emit velocityChanged();
+
+    setRotation(rotation);
+    setEnergy(energy);
+    setAlive(alive);
 }
 
 QJsonObject Player::serialize()
@@ -155,42 +183,6 @@ QJsonObject Player::serialize()
     return playerObject;
 }
 
-void Player::decreaseEnergy(int amount)
-{
-    if (m_energy <= 0) {
-        return;
-    }
-
-    m_energy -= amount;
-    if (m_energy < 0) m_energy = 0;
-
-    emit energyChanged();
-
-    if (m_energy == 0 && m_alive) {
-        setAlive(false);
-    }
-}
-
-void Player::increaseEnergy(int amount)
-{
-    if (m_energy <= 0) {
-        return;
-    }
-
-    m_energy += amount;
-    emit energyChanged();
-}
-
-void Player::rotate(int amount)
-{
-    if (m_energy <= 0) {
-        return;
-    }
-
-    decreaseEnergy(ROTATE_COST);
-    setRotation(m_rotation + amount);
-}
-
 void Player::setEnergy(int energy)
 {
     if (energy == m_energy) {
@@ -200,56 +192,3 @@ void Player::setEnergy(int energy)
     m_energy = energy;
     emit energyChanged();
 }
-
-void Player::accelerate()
-{
-    if (m_energy <= 0) {
-        return;
-    }
-
-    qreal angle = m_rotation * M_PI * 2.0 / 360.0;
-    m_velocityX += cos(angle) * ACCELERATION_FORCE;
-    m_velocityY += sin(angle) * ACCELERATION_FORCE;
-    decreaseEnergy(ACCELERATION_COST);
-}
-
-void Player::doMove()
-{
-    if (m_energy <= 0) {
-        return;
-    }
-
-    qreal x = m_position.x();
-    qreal y = m_position.y();
-
-    const qreal angle = atan2(y, x);
-    const qreal distance = hypot(x, y);
-
-    if (distance < 0.1) {
-        m_alive = false;
-        emit aliveChanged();
-        return;
-    }
-
-    const qreal force = distance / m_energy;
-    m_velocityX -= cos(angle) * force;
-    m_velocityY -= sin(angle) * force;
-
-    if (m_velocityX > 0.05) m_velocityX = 0.05;
-    if (m_velocityY > 0.05) m_velocityY = 0.05;
-    if (m_velocityX < -0.05) m_velocityX = -0.05;
-    if (m_velocityY < -0.05) m_velocityY = -0.05;
-
-    x += m_velocityX;
-    y += m_velocityY;
-
-    if (x > 1.0) { x = -1.0; }
-    if (y > 1.0) { y = -1.0; }
-    if (x < -1.0) { x = 1.0; }
-    if (y < -1.0) { y = 1.0; }
-
-    m_position.setX(x);
-    m_position.setY(y);
-    emit positionChanged();
-    emit velocityChanged();
-}
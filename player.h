@@ -21,6 +21,7 @@ class Player : public QObject
     Q_PROPERTY(QUrl spritePath MEMBER m_spritePath NOTIFY spritePathChanged())
     Q_PROPERTY(bool alive READ isAlive() NOTIFY aliveChanged())
     Q_PROPERTY(QPointF position READ position WRITE setPosition NOTIFY positionChanged)
+    Q_PROPERTY(QPointF displayPosition READ displayPosition NOTIFY displayPositionChanged)
     Q_PROPERTY(int energy READ energy NOTIFY energyChanged)
     Q_PROPERTY(int rotation READ rotation NOTIFY rotationChanged)
     Q_PROPERTY(qreal velocityX MEMBER m_velocityX NOTIFY velocityChanged)
@@ -34,6 +35,7 @@ public:
     bool isDisconnected() { return m_disconnected; }
 
     QString lastCommand();
+    void setLastCommand(const QString &command);
     QString command();
 
     QString name();
@@ -50,25 +52,26 @@ public:
     int score() const { return m_score; }
     void resetScore() { m_score = 0; m_wins = 0; emit scoreChanged(); emit winsChanged(); }
 
-    void doMove();
-
     void setAlive(bool alive);
     bool isAlive();
 
     void setRotation(int rotation);
-    void rotate(int amount);
     int rotation() { return m_rotation; }
 
     int energy() { return m_energy; }
     void setEnergy(int energy);
-    void decreaseEnergy(int amount);
-    void increaseEnergy(int amount);
-    void accelerate();
 
     QPointF position() const { return m_position; }
     void setPosition(QPointF position);
 
-    void setVelocity(qreal vx, qreal vy);
+    // Where to draw the player in the current frame, between the last two ticks
+    QPointF displayPosition() const { return m_displayPosition; }
+    void setDisplayPosition(QPointF position);
+
+    // Sets everything that moves in one go, for playing back recordings
+    void setState(QPointF position, qreal velocityX, qreal velocityY, int rotation, int energy, bool alive);
+    qreal velocityX() const { return m_velocityX; }
+    qreal velocityY() const { return m_velocityY; }
 
     QJsonObject serialize();
 
@@ -99,6 +102,7 @@ signals:
     void aliveChanged();
     void energyChanged();
     void positionChanged();
+    void displayPositionChanged();
     void rotationChanged();
     void velocityChanged();
 
@@ -120,6 +124,7 @@ private:
     int m_energy;
     int m_rotation;
     QPointF m_position;
+    QPointF m_displayPosition;
     qreal m_velocityX;
     qreal m_velocityY;
 
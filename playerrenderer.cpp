@@ -0,0 +1,320 @@
+#include "playerrenderer.h"
+
+#include "gamemanager.h"
+#include "atlasnode.h"
+#include "playersprites.h"
+
+#include <QColor>
+#include <QFont>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPainterPath>
+#include <QQuickWindow>
+#include <QSGVertexColorMaterial>
+#include <QTransform>
+
+// Segments in each energy ring
+#define RING_SEGMENTS 32
+
+namespace {
+
+QColor colorForPlayer(const QVariantList &colors, int player)
+{
+    if (colors.isEmpty()) {
+        return Qt::white;
+    }
+    return colors[player % colors.count()].value<QColor>();
+}
+
+// Where cell number index is in a texture laid out in columns x however many rows
+QRect cellRect(int index, const QSize &cellSize, int columns)
+{
+    return QRect(QPoint((index % columns) * cellSize.width(), (index / columns) * cellSize.height()), cellSize);
+}
+
+}
+
+PlayerRenderer::PlayerRenderer(QQuickItem *parent) : QQuickItem(parent),
+    m_spriteColumns(1),
+    m_spritesChanged(true),
+    m_nameColumns(1),
+    m_namesChanged(true)
+{
+    setFlag(ItemHasContents, true);
+
+    // Every player gets its own sprite, there aren't many pixels in them
+    QList<QImage> sprites;
+    m_spriteSize = QSize(1, 1);
+    for (int i=0; i<MAX_PLAYERS; i++) {
+        sprites.append(playerSprite(i));
+        m_spriteSize = m_spriteSize.expandedTo(sprites.last().size());
+    }
+
+    m_spriteColumns = AtlasNode::gridColumns(sprites.count(), m_spriteSize);
+    const int spriteRows = (sprites.count() + m_spriteColumns - 1) / m_spriteColumns;
+    m_sprites = QImage(m_spriteSize.width() * m_spriteColumns, m_spriteSize.height() * spriteRows, QImage::Format_ARGB32_Premultiplied);
+    m_sprites.fill(Qt::transparent);
+
+    QPainter painter(&m_sprites);
+    for (int i=0; i<sprites.count(); i++) {
+        painter.drawImage(cellRect(i, m_spriteSize, m_spriteColumns).topLeft(), sprites[i]);
+    }
+    painter.end();
+
+    createNames();
+}
+
+QObject *PlayerRenderer::game() const
+{
+    return m_game.data();
+}
+
+void PlayerRenderer::setGame(QObject *game)
+{
+    GameManager *manager = qobject_cast<GameManager*>(game);
+    if (manager == m_game) {
+        return;
+    }
+
+    if (m_game) {
+        disconnect(m_game, &GameManager::frameAdvanced, this, &PlayerRenderer::onFrameAdvanced);
+    }
+
+    m_game = manager;
+
+    if (m_game) {
+        connect(m_game, &GameManager::frameAdvanced, this, &PlayerRenderer::onFrameAdvanced);
+    }
+
+    emit gameChanged();
+    onFrameAdvanced();
+}
+
+void PlayerRenderer::setColors(const QVariantList &colors)
+{
+    if (colors == m_colors) {
+        return;
+    }
+
+    m_colors = colors;
+    emit colorsChanged();
+    update();
+}
+
+void PlayerRenderer::onFrameAdvanced()
+{
+    if (m_game) {
+        m_ships = m_game->displayedShips();
+
+        const QStringList names = m_game->playerNames();
+        if (names != m_names) {
+            m_names = names;
+            createNames();
+        }
+    } else {
+        m_ships.clear();
+    }
+
+    update();
+}
+
+void PlayerRenderer::createNames()
+{
+    QFont font("Aldrich");
+    font.setPointSize(10);
+    const QFontMetrics metrics(font);
+
+    // Room for the outline on all sides
+    m_nameSize = QSize(1, metrics.height() + 4);
+    for (const QString &name : m_names) {
+        m_nameSize.setWidth(qMax(m_nameSize.width(), metrics.width(name) + 4));
+    }
+
+    const int nameCount = qMax(1, m_names.count() * 2);
+    m_nameColumns = AtlasNode::gridColumns(nameCount, m_nameSize);
+    const int nameRows = (nameCount + m_nameColumns - 1) / m_nameColumns;
+    m_nameAtlas = QImage(m_nameSize.width() * m_nameColumns, m_nameSize.height() * nameRows, QImage::Format_ARGB32_Premultiplied);
+    m_nameAtlas.fill(Qt::transparent);
+
+    QPainter painter(&m_nameAtlas);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (int i=0; i<m_names.count(); i++) {
+        for (int struck=0; struck<2; struck++) {
+            QFont nameFont(font);
+            nameFont.setStrikeOut(struck);
+
+            const QRect cell = cellRect(i * 2 + struck, m_nameSize, m_nameColumns);
+            const QPointF baseline(cell.left() + (m_nameSize.width() - metrics.width(m_names[i])) / 2.0, cell.top() + 2 + metrics.ascent());
+
+            QPainterPath path;
+            path.addText(baseline, nameFont, m_names[i]);
+            painter.strokePath(path, QPen(Qt::black, 2));
+            painter.fillPath(path, Qt::white);
+        }
+    }
+    painter.end();
+
+    m_namesChanged = true;
+}
+
+QSGNode *PlayerRenderer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    if (PainterNode::isNeeded(window())) {
+        return updatePainterNode(static_cast<PainterNode*>(oldNode));
+    }
+
+    QSGNode *root = oldNode;
+    if (!root) {
+        root = new QSGNode;
+
+        QSGGeometryNode *ringNode = new QSGGeometryNode;
+        QSGGeometry *ringGeometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        ringGeometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        ringNode->setGeometry(ringGeometry);
+        ringNode->setMaterial(new QSGVertexColorMaterial);
+        ringNode->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+
+        root->appendChildNode(ringNode);
+        root->appendChildNode(new AtlasNode);
+        root->appendChildNode(new AtlasNode);
+
+        m_spritesChanged = true;
+        m_namesChanged = true;
+    }
+
+    QSGGeometryNode *ringNode = static_cast<QSGGeometryNode*>(root->childAtIndex(0));
+    AtlasNode *spriteNode = static_cast<AtlasNode*>(root->childAtIndex(1));
+    AtlasNode *nameNode = static_cast<AtlasNode*>(root->childAtIndex(2));
+
+    if (m_spritesChanged) {
+        spriteNode->setTexture(window()->createTextureFromImage(m_sprites));
+        m_spritesChanged = false;
+    }
+    if (m_namesChanged) {
+        nameNode->setTexture(window()->createTextureFromImage(m_nameAtlas), QSGTexture::Linear);
+        m_namesChanged = false;
+    }
+
+    // Same size as the sprites used to be
+    const qreal size = qMin(width(), height()) / 20;
+    const int playerCount = int(m_ships.size());
+
+    QSGGeometry *ringGeometry = ringNode->geometry();
+    ringGeometry->allocate(playerCount * RING_SEGMENTS * 6);
+    QSGGeometry::ColoredPoint2D *ringVertices = ringGeometry->vertexDataAsColoredPoint2D();
+
+    int aliveCount = 0;
+    for (const ShipState &ship : m_ships) {
+        if (ship.alive) {
+            aliveCount++;
+        }
+    }
+    spriteNode->allocateQuads(aliveCount);
+    nameNode->allocateQuads(qMin(playerCount, m_names.count()));
+
+    const QTransform toSpriteTexture = QTransform::fromScale(1.0 / m_sprites.width(), 1.0 / m_sprites.height());
+    const QTransform toNameTexture = QTransform::fromScale(1.0 / m_nameAtlas.width(), 1.0 / m_nameAtlas.height());
+    const int spriteCount = MAX_PLAYERS;
+
+    int sprite = 0;
+    QPointF corners[4];
+    for (int i=0; i<playerCount; i++) {
+        const ShipState &ship = m_ships[i];
+        const QPointF center(width() / 2 + ship.x * width() / 2, height() / 2 + ship.y * height() / 2);
+
+        // The ring is as thick as the energy, from the edge and inwards
+        const QColor color = colorForPlayer(m_colors, i);
+        const uchar alpha = color.alpha();
+        const uchar red = color.red() * alpha / 255, green = color.green() * alpha / 255, blue = color.blue() * alpha / 255;
+        const float outer = size / 2;
+        const float inner = qMax(0.0, outer - qMax(ship.energy, 0) / 50.0);
+        for (int segment=0; segment<RING_SEGMENTS; segment++) {
+            const qreal from = segment * 2 * M_PI / RING_SEGMENTS;
+            const qreal to = (segment + 1) * 2 * M_PI / RING_SEGMENTS;
+            const QPointF fromDirection(qCos(from), qSin(from));
+            const QPointF toDirection(qCos(to), qSin(to));
+            const QPointF outerFrom = center + fromDirection * outer, innerFrom = center + fromDirection * inner;
+            const QPointF outerTo = center + toDirection * outer, innerTo = center + toDirection * inner;
+
+            ringVertices[0].set(outerFrom.x(), outerFrom.y(), red, green, blue, alpha);
+            ringVertices[1].set(outerTo.x(), outerTo.y(), red, green, blue, alpha);
+            ringVertices[2].set(innerTo.x(), innerTo.y(), red, green, blue, alpha);
+            ringVertices[3].set(outerFrom.x(), outerFrom.y(), red, green, blue, alpha);
+            ringVertices[4].set(innerTo.x(), innerTo.y(), red, green, blue, alpha);
+            ringVertices[5].set(innerFrom.x(), innerFrom.y(), red, green, blue, alpha);
+            ringVertices += 6;
+        }
+
+        if (ship.alive) {
+            // The sprites point up, the rotation is from the x axis
+            AtlasNode::rotatedSquare(center, size, qDegreesToRadians(ship.rotation + 90.0), corners);
+            spriteNode->setQuad(sprite++, corners, toSpriteTexture.mapRect(QRectF(cellRect(i % spriteCount, m_spriteSize, m_spriteColumns))));
+        }
+
+        // Centered at the bottom of the sprite
+        if (i < m_names.count()) {
+            const QRectF target(center.x() - m_nameSize.width() / 2.0, center.y() + size / 2 - m_nameSize.height(), m_nameSize.width(), m_nameSize.height());
+            const QRect source = cellRect(i * 2 + (ship.alive ? 0 : 1), m_nameSize, m_nameColumns);
+            nameNode->setQuad(i, target, toNameTexture.mapRect(QRectF(source)));
+        }
+    }
+
+    ringNode->markDirty(QSGNode::DirtyGeometry);
+    spriteNode->markDirty(QSGNode::DirtyGeometry);
+    nameNode->markDirty(QSGNode::DirtyGeometry);
+    return root;
+}
+
+QSGNode *PlayerRenderer::updatePainterNode(PainterNode *node)
+{
+    if (!node) {
+        node = new PainterNode(this);
+    }
+
+    QList<QColor> colors;
+    for (size_t i=0; i<m_ships.size(); i++) {
+        colors.append(colorForPlayer(m_colors, int(i)));
+    }
+
+    const std::vector<ShipState> ships = m_ships;
+    const QImage sprites = m_sprites;
+    const QSize spriteSize = m_spriteSize;
+    const int spriteColumns = m_spriteColumns;
+    const QImage nameAtlas = m_nameAtlas;
+    const QSize nameSize = m_nameSize;
+    const int nameColumns = m_nameColumns;
+    const int nameCount = m_names.count();
+    const qreal itemWidth = width(), itemHeight = height();
+    const qreal size = qMin(width(), height()) / 20;
+
+    node->setPaint([=](QPainter *painter) {
+        painter->setRenderHint(QPainter::Antialiasing);
+
+        for (int i=0; i<int(ships.size()); i++) {
+            const ShipState &ship = ships[i];
+            const QPointF center(itemWidth / 2 + ship.x * itemWidth / 2, itemHeight / 2 + ship.y * itemHeight / 2);
+
+            // The ring is as thick as the energy, from the edge and inwards
+            const qreal thickness = qMin(size / 2, qMax(ship.energy, 0) / 50.0);
+            if (thickness > 0) {
+                painter->setPen(QPen(colors[i], thickness));
+                painter->setBrush(Qt::NoBrush);
+                const qreal radius = (size - thickness) / 2;
+                painter->drawEllipse(center, radius, radius);
+            }
+
+            if (ship.alive) {
+                const QRect source = cellRect(i % MAX_PLAYERS, spriteSize, spriteColumns);
+                PainterNode::drawRotated(painter, sprites, source, center, size, qDegreesToRadians(ship.rotation + 90.0));
+            }
+
+            if (i < nameCount) {
+                const QPointF topLeft(center.x() - nameSize.width() / 2.0, center.y() + size / 2 - nameSize.height());
+                painter->drawImage(topLeft, nameAtlas, cellRect(i * 2 + (ship.alive ? 0 : 1), nameSize, nameColumns));
+            }
+        }
+    });
+
+    node->markDirty(QSGNode::DirtyMaterial);
+    return node;
+}
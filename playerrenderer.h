@@ -0,0 +1,72 @@
+#ifndef PLAYERRENDERER_H
+#define PLAYERRENDERER_H
+
+#include <QQuickItem>
+#include <QPointer>
+#include <QVariantList>
+#include <QStringList>
+#include <QImage>
+
+#include "world.h"
+
+class GameManager;
+class PainterNode;
+
+// Draws all the players, with their energy ring and name, in three scene graph
+// nodes whatever the number of players: one for the rings, one for the ships
+// and one for the names. The ships and names come from textures made up front.
+// Place it over the whole game area.
+class PlayerRenderer : public QQuickItem
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QObject *game READ game WRITE setGame NOTIFY gameChanged)
+    Q_PROPERTY(QVariantList colors READ colors WRITE setColors NOTIFY colorsChanged)
+
+public:
+    explicit PlayerRenderer(QQuickItem *parent = nullptr);
+
+    QObject *game() const;
+    void setGame(QObject *game);
+
+    // One colour per player, for the energy rings
+    QVariantList colors() const { return m_colors; }
+    void setColors(const QVariantList &colors);
+
+signals:
+    void gameChanged();
+    void colorsChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override;
+
+private slots:
+    void onFrameAdvanced();
+
+private:
+    void createNames();
+
+    // For the software backend
+    QSGNode *updatePainterNode(PainterNode *node);
+
+    QPointer<GameManager> m_game;
+    QVariantList m_colors;
+
+    // Copy of where the players are in this frame, so we can draw them while the game goes on
+    std::vector<ShipState> m_ships;
+
+    // The ship sprites for every player, in a grid
+    QImage m_sprites;
+    QSize m_spriteSize;
+    int m_spriteColumns;
+    bool m_spritesChanged;
+
+    // Every name twice, the second one struck out for when they're dead
+    QStringList m_names;
+    QImage m_nameAtlas;
+    QSize m_nameSize;
+    int m_nameColumns;
+    bool m_namesChanged;
+};
+
+#endif // PLAYERRENDERER_H
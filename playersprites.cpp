@@ -0,0 +1,74 @@
+#include "playersprites.h"
+
+#include <QPainter>
+#include <QtMath>
+
+// How many ship sprites there are in sprites/players/
+#define PLAYER_SPRITE_COUNT 4
+
+// How much of the player's colour to paint over the reused sprites
+#define PLAYER_TINT_STRENGTH 0.6
+
+QColor playerColor(int player)
+{
+    static const QColor colors[PLAYER_SPRITE_COUNT] = {
+        QColor(0xff, 0x40, 0x0f, 0xc0), // red
+        QColor(0x40, 0x0f, 0xff, 0xc0), // blue
+        QColor(0x40, 0xff, 0x0f, 0xc0), // green
+        QColor(0xf0, 0xff, 0x40, 0xc0)  // yellow
+    };
+
+    if (player < PLAYER_SPRITE_COUNT) {
+        return colors[qMax(player, 0)];
+    }
+
+    // Stepping by the golden ratio keeps the neighbours far apart, however many there are
+    const qreal hue = player * 0.618033988749895;
+    return QColor::fromHsvF(hue - qFloor(hue), 0.75, 1.0, 0xc0 / 255.0);
+}
+
+QVariantList playerColorList(int count)
+{
+    QVariantList colors;
+    for (int i=0; i<count; i++) {
+        colors.append(playerColor(i));
+    }
+    return colors;
+}
+
+QImage playerSprite(int player)
+{
+    player = qMax(player, 0);
+    QImage sprite = QImage(":/sprites/players/player" + QString::number(player % PLAYER_SPRITE_COUNT) + ".png").convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (player < PLAYER_SPRITE_COUNT) {
+        return sprite;
+    }
+
+    // Only where the sprite is, and keep some of the shading
+    QColor tint = playerColor(player);
+    tint.setAlphaF(PLAYER_TINT_STRENGTH);
+    QPainter painter(&sprite);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceAtop);
+    painter.fillRect(sprite.rect(), tint);
+    painter.end();
+
+    return sprite;
+}
+
+PlayerSpriteProvider::PlayerSpriteProvider() : QQuickImageProvider(QQuickImageProvider::Image)
+{
+}
+
+QImage PlayerSpriteProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    QImage sprite = playerSprite(id.toInt());
+    if (size) {
+        *size = sprite.size();
+    }
+
+    if (requestedSize.isValid()) {
+        sprite = sprite.scaled(requestedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    return sprite;
+}
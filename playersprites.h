@@ -0,0 +1,25 @@
+#ifndef PLAYERSPRITES_H
+#define PLAYERSPRITES_H
+
+#include <QColor>
+#include <QImage>
+#include <QQuickImageProvider>
+#include <QVariantList>
+
+// The first players get the hand drawn ships and their own colours. After
+// that the same ships are reused, tinted with colours spread out around the
+// colour wheel, so any number of players can tell themselves apart.
+QColor playerColor(int player);
+QVariantList playerColorList(int count);
+QImage playerSprite(int player);
+
+// Makes the ship sprites for QML, as image://players/<player>
+class PlayerSpriteProvider : public QQuickImageProvider
+{
+public:
+    PlayerSpriteProvider();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+};
+
+#endif // PLAYERSPRITES_H
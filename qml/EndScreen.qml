@@ -34,20 +34,23 @@ Rectangle {
         anchors.bottom: quitButton.top
         anchors.margins: 20
         border.color: "white"
-        Column {
-            anchors.horizontalCenter: parent.horizontalCenter
-            anchors.top: parent.top
+        width: parent.width / 2
+
+        // Only makes delegates for the rows in view, there might be a lot of players
+        ListView {
+            id: userListView
+            anchors.fill: parent
             anchors.margins: 20
-            Repeater {
-                model: endScreen.visible ? GameManager.players : 0 // Only fetch players when finished, to get them correctly sorted
-                delegate: Text {
-                    horizontalAlignment: Text.AlignHCenter
-                    color: "white"
-                    font.pointSize: 20
-                    font.bold: true
-                    font.family: "Aldrich"
-                    text: (index + 1) + ". " + model.modelData.name + ": " + model.modelData.wins + " wins" + " (" + model.modelData.score + " hits)"
-                }
+            clip: true
+            model: GameManager.scoreboard
+            delegate: Text {
+                width: userListView.width
+                horizontalAlignment: Text.AlignHCenter
+                color: "white"
+                font.pointSize: 20
+                font.bold: true
+                font.family: "Aldrich"
+                text: (index + 1) + ". " + name + ": " + wins + " wins" + " (" + score + " hits)"
             }
         }
     }
@@ -80,10 +83,10 @@ Rectangle {
         anchors.leftMargin: 10
         width: 200
         height: 50
-        visible: GameManager.players.length > 0
+        visible: GameManager.scoreboard.count > 0
 
         onClicked: {
-            if (GameManager.players.length < 1) {
+            if (GameManager.scoreboard.count < 1) {
                 return
             }
             GameManager.stopGame()
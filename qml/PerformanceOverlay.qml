@@ -0,0 +1,42 @@
+import QtQuick 2.0
+
+Rectangle {
+    id: overlay
+    width: 360
+    height: column.height + 20
+    color: "#c0000000"
+    border.color: "white"
+
+    property QtObject monitor
+
+    Column {
+        id: column
+        x: 10
+        y: 10
+        width: parent.width - 20
+
+        Text {
+            color: "white"
+            font.pixelSize: 14
+            text: "ticks: " + monitor.tickRate.toFixed(1) + "/s" +
+                  "\nstep: " + monitor.stepTime.toFixed(2) + " ms" +
+                  "  sync: " + monitor.syncTime.toFixed(2) + " ms" +
+                  "  send: " + monitor.sendTime.toFixed(2) + " ms" +
+                  "\nframe: " + monitor.frameTime.toFixed(1) + " ms" +
+                  "\nmissiles: " + monitor.missileCount +
+                  "\nitems: " + monitor.itemCount +
+                  "\nparticles: ~" + monitor.particleCount + " (budget " + Math.round(monitor.particleScale * 100) + "%)"
+        }
+
+        Repeater {
+            model: monitor.bots
+            delegate: Text {
+                color: "white"
+                font.pixelSize: 14
+                text: modelData.name + ": " + modelData.latency.toFixed(1) + " ms, " +
+                      Math.round(modelData.bytesIn) + " B/s in, " +
+                      Math.round(modelData.bytesOut) + " B/s out"
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+import QtQuick 2.0
+
+Rectangle {
+    id: replayControls
+
+    property var replay
+
+    height: 60
+    color: "#7f000000"
+    border.color: "white"
+    border.width: 1
+
+    Text {
+        id: statusText
+        anchors.left: parent.left
+        anchors.verticalCenter: parent.verticalCenter
+        anchors.leftMargin: 10
+        width: 360
+        color: "white"
+        font.pixelSize: 20
+        text: (replay.playing ? "PLAYING " : "PAUSED ") + replay.speed + "x" +
+              "  round " + (replay.round + 1) + "  tick " + replay.tick
+    }
+
+    Rectangle {
+        id: track
+        anchors {
+            left: statusText.right
+            right: parent.right
+            verticalCenter: parent.verticalCenter
+            rightMargin: 20
+        }
+        height: 20
+        color: "transparent"
+        border.color: "white"
+
+        Rectangle {
+            anchors.left: parent.left
+            anchors.top: parent.top
+            anchors.bottom: parent.bottom
+            anchors.margins: 3
+            color: "white"
+            opacity: 0.7
+            width: replay.frameCount > 1 ? (parent.width - 6) * replay.frame / (replay.frameCount - 1) : 0
+        }
+
+        MouseArea {
+            anchors.fill: parent
+            cursorShape: Qt.PointingHandCursor
+
+            function scrub(mouseX) {
+                replay.seek(Math.round(replay.frameCount * Math.max(0, Math.min(1, mouseX / width))))
+            }
+
+            onPressed: scrub(mouse.x)
+            onPositionChanged: scrub(mouse.x)
+        }
+    }
+}
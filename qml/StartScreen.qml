@@ -17,7 +17,7 @@ Item {
 
     Emitter {
         lifeSpan: 4000
-        emitRate: 120
+        emitRate: 120 * ParticleBudget.scale
         size: 12
         anchors.centerIn: parent
         enabled: parent.visible
@@ -29,6 +29,7 @@ Item {
             to: 360;
             loops: -1;
             running: true
+            paused: IdleMonitor.idle
             duration: 24000
         }
         function convert(a) {return a*(Math.PI/180);}
@@ -62,7 +63,7 @@ Item {
         anchors.horizontalCenter: parent.horizontalCenter
         width: height
         enabled: parent.visible
-        emitRate: 5000
+        emitRate: 5000 * ParticleBudget.scale
         lifeSpan: 2000
         size: 15
         sizeVariation: 15
@@ -117,14 +118,14 @@ Item {
             anchors.topMargin: 10
             anchors.right: parent.right
             anchors.rightMargin: 10
-            opacity: (GameManager.players.length < GameManager.maxPlayers || checked) ? 1 : 0
-            enabled: GameManager.players.length < GameManager.maxPlayers || checked
+            opacity: (GameManager.scoreboard.count < GameManager.maxPlayers || checked) ? 1 : 0
+            enabled: GameManager.scoreboard.count < GameManager.maxPlayers || checked
             onClicked: {
                 if (checked) {
                     GameManager.removeHumanPlayer()
                     checked = false
                 } else {
-                    if (GameManager.players.length >= GameManager.maxPlayers) return;
+                    if (GameManager.scoreboard.count >= GameManager.maxPlayers) return;
 
                     GameManager.addPlayer()
                     checked = true
@@ -146,7 +147,7 @@ Item {
             anchors.verticalCenter: parent.verticalCenter
             anchors.right: parent.right
             anchors.rightMargin: 10
-            checked: Settings.getValue(Settings.EnableEffects, true)
+            checked: Settings.enableEffects
 
             function handleValue() {
                 particleSystem.restart() // quick hack to kill all particles
@@ -156,12 +157,9 @@ Item {
             }
 
             Component.onCompleted: handleValue()
+            onCheckedChanged: handleValue()
 
-            onClicked: {
-                checked = !checked
-                Settings.setValue(Settings.EnableEffects, checked)
-                handleValue()
-            }
+            onClicked: Settings.enableEffects = !Settings.enableEffects
 
             Text {
                 anchors.right: parent.left
@@ -194,7 +192,7 @@ Item {
             anchors.verticalCenter: parent.verticalCenter
             anchors.left: parent.left
             anchors.margins: 10
-            text: "Connected users: " + GameManager.players.length + "/" + GameManager.maxPlayers;
+            text: "Connected users: " + GameManager.scoreboard.count + "/" + GameManager.maxPlayers;
         }
     }
 
@@ -210,44 +208,44 @@ Item {
         border.color: "white"
         border.width: 1
 
-        Column {
+        // Only makes delegates for the rows in view, there might be a lot of players
+        ListView {
             id: userListColumn
             anchors.fill: parent
             anchors.margins: 20
             spacing: 10
-            Repeater {
-                model: GameManager.players
-                delegate: Item {
-                    height: 40
-                    width: userListColumn.width
-                    Image {
-                        source: modelData.spritePath
-                        width: 30
-                        height: width
-                        anchors {
-                            left: parent.left
-                            verticalCenter: parent.verticalCenter
-                        }
-
-                        Text {
-                            anchors.left: parent.right
-                            anchors.verticalCenter: parent.verticalCenter
-                            color: "white"
-                            font.pixelSize: 20
-                            text: modelData.name
-                        }
+            clip: true
+            model: GameManager.scoreboard
+            delegate: Item {
+                height: 40
+                width: userListColumn.width
+                Image {
+                    source: player.spritePath
+                    width: 30
+                    height: width
+                    anchors {
+                        left: parent.left
+                        verticalCenter: parent.verticalCenter
                     }
 
-                    Button {
-                        visible: !modelData.isHuman()
-                        anchors.right: parent.right
-                        width: 60
-                        height: 30
-                        text: "Kick"
-                        fontSize: 10
-                        onClicked: GameManager.kick(index)
+                    Text {
+                        anchors.left: parent.right
+                        anchors.verticalCenter: parent.verticalCenter
+                        color: "white"
+                        font.pixelSize: 20
+                        text: name
                     }
                 }
+
+                Button {
+                    visible: !player.isHuman()
+                    anchors.right: parent.right
+                    width: 60
+                    height: 30
+                    text: "Kick"
+                    fontSize: 10
+                    onClicked: GameManager.kick(player.id)
+                }
             }
         }
     }
@@ -263,9 +261,9 @@ Item {
         }
         height: 60
         text: "Start game"
-        active: (GameManager.players.length > 0)
+        active: (GameManager.scoreboard.count > 0)
         onClicked: {
-            if (GameManager.players.length < 1) {
+            if (GameManager.scoreboard.count < 1) {
                 return
             }
             GameManager.startGame()
@@ -2,6 +2,7 @@ import QtQuick 2.2
 import QtQuick.Window 2.2
 import QtGraphicalEffects 1.0
 import QtQuick.Particles 2.0
+import org.gathering.turnonme 1.0
 
 Rectangle {
     id: main
@@ -13,12 +14,7 @@ Rectangle {
 
     property int scaleSize: (width < height) ? width : height
 
-    property var playerColors: [
-        "#c0ff400f", // red
-        "#c0400fff", // blue
-        "#c040ff0f", // green
-        "#c0f0ff40"  // yellow
-    ]
+    property var playerColors: GameManager.playerColors
 
     signal userMove(string direction)
 
@@ -27,6 +23,11 @@ Rectangle {
     Keys.onRightPressed: userMove("RIGHT")
     Keys.onLeftPressed: userMove("LEFT")
     Keys.onEscapePressed: {
+        if (GameManager.replay) {
+            Qt.quit()
+            return
+        }
+
         GameManager.stopGame();
     }
 
@@ -39,12 +40,22 @@ Rectangle {
             pauseText.visible = !pauseText.visible
             pauseAnimation.restart()
             return true;
+        } else if (event.key === Qt.Key_O) {
+            performanceOverlay.visible = !performanceOverlay.visible
+            PerformanceMonitor.active = performanceOverlay.visible
+            return true;
         } else if (event.key === Qt.Key_Period) {
             userMove("SEEKING")
         } else if (event.key === Qt.Key_Comma) {
             userMove("MINE")
         } else if (event.key === Qt.Key_M) {
             userMove("MISSILE")
+        } else if (event.key === Qt.Key_Plus && GameManager.replay) {
+            GameManager.replay.faster()
+            return true;
+        } else if (event.key === Qt.Key_Minus && GameManager.replay) {
+            GameManager.replay.slower()
+            return true;
         }
 
         return false;
@@ -144,7 +155,7 @@ Rectangle {
 
             Emitter {
                 anchors.fill: parent
-                emitRate: 1000
+                emitRate: 1000 * ParticleBudget.scale
                 lifeSpan: 2000
                 size: 20
                 sizeVariation: 5
@@ -166,8 +177,7 @@ Rectangle {
         ParticleSystem {
             id: particleSystem
             anchors.fill: parent
-
-            property var particleGroups: ["Player1", "Player2", "Player3", "Player4"]
+            paused: IdleMonitor.idle
 
             ImageParticle {
                 opacity: 0.5
@@ -232,7 +242,7 @@ Rectangle {
             anchors.centerIn: parent
             width: 10
             height: 10
-            emitRate: 1000
+            emitRate: 1000 * ParticleBudget.scale
             lifeSpan: 250
             lifeSpanVariation: 100
             enabled: false
@@ -246,66 +256,63 @@ Rectangle {
                 target: GameManager
                 onExplosion: {
                     blurAnimation.restart()
-                    crashEmitter.burst(500, main.width / 2 + position.x * main.width / 2, main.height/ 2 + position.y * main.height/ 2)
+                    crashEmitter.burst(500 * ParticleBudget.scale, main.width / 2 + position.x * main.width / 2, main.height/ 2 + position.y * main.height/ 2)
+                }
+                onPlayerDied: {
+                    blurAnimation.restart()
+                    crashEmitter.burst(1000 * ParticleBudget.scale, main.width / 2 + position.x * main.width / 2, main.height/ 2 + position.y * main.height/ 2)
                 }
             }
         }
 
-        Component {
-            id: missileSpriteSpawner
-
-            MissileSprite {
-            }
-        }
-        Connections {
-            target: GameManager
-            onMissileCreated: {
-                missileSpriteSpawner.createObject(gameArea, {"missileData": missile})
-            }
+        MissileRenderer {
+            anchors.fill: parent
+            game: GameManager
+            colors: playerColors
         }
 
 
-        // List of names of players
-        Column {
+        // List of names of players, only the leaders when there are many
+        ListView {
             anchors.left: parent.left
             anchors.top: parent.top
-            height: 100
-            width: 100
-            Repeater {
-                model: GameManager.players
-                delegate: Image {
-                    source: modelData.spritePath
-                    height: 45
-                    width: height
-
-
-                    Rectangle {
-                        anchors.left: parent.right
-                        anchors.top: parent.top
-                        anchors.bottom: parent.bottom
-                        color: playerColors[modelData.id]
-                        opacity: modelData.energy / 2000 + 0.5
-                        width: 400 * modelData.energy / 1000
-                        Behavior on width { NumberAnimation { duration: 60; } }
-                        ColorAnimation on color {
-                            id: coloranim
-                            duration: 100
-                            from: "white"
-                            to: playerColors[modelData.id]
-                        }
-                    }
-                    Text {
-                        anchors.verticalCenter: parent.verticalCenter
-                        anchors.left: parent.right
-                        text: modelData.name + ": " + modelData.energy
-                        color: "white"
-                        style: Text.Outline
-                        styleColor: "black"
-                        font.family: "Aldrich"
-                        font.pointSize: 20
-                        font.strikeout: !modelData.alive
+            height: Math.min(count, 8) * 45
+            width: parent.width
+            interactive: false
+            clip: true
+            model: GameManager.scoreboard
+            delegate: Image {
+                source: player.spritePath
+                height: 45
+                width: height
+
+
+                Rectangle {
+                    anchors.left: parent.right
+                    anchors.top: parent.top
+                    anchors.bottom: parent.bottom
+                    color: playerColors[player.id]
+                    opacity: energy / 2000 + 0.5
+                    width: 400 * energy / 1000
+                    Behavior on width { NumberAnimation { duration: 60; } }
+                    ColorAnimation on color {
+                        id: coloranim
+                        duration: 100
+                        from: "white"
+                        to: playerColors[player.id]
                     }
                 }
+                Text {
+                    anchors.verticalCenter: parent.verticalCenter
+                    anchors.left: parent.right
+                    text: name + ": " + energy
+                    color: "white"
+                    style: Text.Outline
+                    styleColor: "black"
+                    font.family: "Aldrich"
+                    font.pointSize: 20
+                    font.strikeout: !alive
+                }
             }
         }
 
@@ -426,14 +433,10 @@ Rectangle {
     }
 
 
-    // List of player sprites
-    Repeater {
-        model: GameManager.players
-        delegate: PlayerSprite {
-            playerId: model.modelData.id
-            height: main.scaleSize / 20
-            width: height
-        }
+    PlayerRenderer {
+        anchors.fill: parent
+        game: GameManager
+        colors: playerColors
     }
 
     focus: true
@@ -449,6 +452,27 @@ Rectangle {
         opacity: GameManager.gameRunning ? 0 : 1
     }
 
+    Loader {
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.bottom: parent.bottom
+        anchors.margins: 10
+        active: GameManager.replay !== null
+        sourceComponent: ReplayControls {
+            replay: GameManager.replay
+        }
+    }
+
+    PerformanceOverlay {
+        id: performanceOverlay
+        anchors.right: parent.right
+        anchors.verticalCenter: parent.verticalCenter
+        anchors.margins: 10
+        monitor: PerformanceMonitor
+        visible: false
+        z: 20
+    }
+
     Text {
         id: aboutText
         anchors.bottom: buildId.top
@@ -0,0 +1,108 @@
+#define _USE_MATH_DEFINES // because windows sucks assss
+#include "rating.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define RATING_MU 25.0
+#define RATING_SIGMA (RATING_MU / 3.0)
+#define RATING_BETA (RATING_SIGMA / 2.0) // Performance variation within a match
+#define RATING_TAU (RATING_SIGMA / 100.0) // Keeps sigma from reaching zero, so ratings can still move
+#define RATING_DRAW_MARGIN (0.1777 * RATING_BETA) // Draws happen 10% of the time between equal bots, like TrueSkill's default
+
+namespace {
+
+double normalPdf(double x)
+{
+    return exp(-x * x / 2) / sqrt(2 * M_PI);
+}
+
+double normalCdf(double x)
+{
+    return erfc(-x / sqrt(2)) / 2;
+}
+
+// How much the means move and the variances shrink, t is the difference in skill
+// and margin the draw margin, both divided by the total deviation
+void winUpdate(double t, double margin, double *v, double *w)
+{
+    const double x = t - margin;
+    *v = normalPdf(x) / std::max(normalCdf(x), 1e-12);
+    *w = *v * (*v + x);
+}
+
+void drawUpdate(double t, double margin, double *v, double *w)
+{
+    const double probability = std::max(normalCdf(margin - t) - normalCdf(-margin - t), 1e-12);
+    *v = (normalPdf(-margin - t) - normalPdf(margin - t)) / probability;
+    *w = *v * *v + ((margin - t) * normalPdf(margin - t) + (margin + t) * normalPdf(margin + t)) / probability;
+}
+
+} // namespace
+
+RatingTable::RatingTable(size_t playerCount)
+{
+    setPlayerCount(playerCount);
+}
+
+void RatingTable::setPlayerCount(size_t playerCount)
+{
+    Rating initial;
+    initial.mu = RATING_MU;
+    initial.sigma = RATING_SIGMA;
+    initial.matches = 0;
+
+    m_ratings.assign(playerCount, initial);
+}
+
+void RatingTable::addResult(const std::vector<int> &players, const std::vector<int> &ranks)
+{
+    const size_t count = players.size();
+    if (count < 2 || ranks.size() != count) {
+        return;
+    }
+
+    // All the updates use the ratings from before the match
+    const std::vector<Rating> before = m_ratings;
+    std::vector<double> muDelta(count, 0);
+    std::vector<double> varianceFactor(count, 1);
+
+    const double weight = 1.0 / (count - 1);
+
+    for (size_t i=0; i<count; i++) {
+        for (size_t j=0; j<count; j++) {
+            // Only look at each pair once, from the winner, or the first one of a draw
+            const bool draw = ranks[i] == ranks[j];
+            if (ranks[i] > ranks[j] || (draw && i >= j)) {
+                continue;
+            }
+
+            const Rating &first = before[players[i]];
+            const Rating &second = before[players[j]];
+            const double firstVariance = first.sigma * first.sigma + RATING_TAU * RATING_TAU;
+            const double secondVariance = second.sigma * second.sigma + RATING_TAU * RATING_TAU;
+
+            const double c = sqrt(2 * RATING_BETA * RATING_BETA + firstVariance + secondVariance);
+            const double t = (first.mu - second.mu) / c;
+            double v, w;
+            if (draw) {
+                drawUpdate(t, RATING_DRAW_MARGIN / c, &v, &w);
+            } else {
+                winUpdate(t, RATING_DRAW_MARGIN / c, &v, &w);
+            }
+
+            muDelta[i] += weight * firstVariance / c * v;
+            muDelta[j] -= weight * secondVariance / c * v;
+            varianceFactor[i] *= 1 - weight * firstVariance / (c * c) * w;
+            varianceFactor[j] *= 1 - weight * secondVariance / (c * c) * w;
+        }
+    }
+
+    for (size_t i=0; i<count; i++) {
+        Rating &rating = m_ratings[players[i]];
+        const double variance = rating.sigma * rating.sigma + RATING_TAU * RATING_TAU;
+        rating.mu += muDelta[i];
+        rating.sigma = sqrt(variance * std::max(varianceFactor[i], 1e-4));
+        rating.matches++;
+    }
+}
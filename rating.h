@@ -0,0 +1,39 @@
+#ifndef RATING_H
+#define RATING_H
+
+#include <cstddef>
+#include <vector>
+
+// Skill of a bot, in the TrueSkill sense: mean and uncertainty
+struct Rating
+{
+    double mu;
+    double sigma;
+    int matches;
+
+    // What the bot is at least as good as, with high probability. Sort by this.
+    double conservative() const { return mu - 3 * sigma; }
+};
+
+// TrueSkill style ratings, updated one match at a time. Matches with more
+// than two players are treated as all the pairwise games implied by the
+// final placement, each with a proportionally smaller weight. Draws count
+// too: they pull the two ratings together, and make both more certain.
+class RatingTable
+{
+public:
+    explicit RatingTable(size_t playerCount = 0);
+
+    void setPlayerCount(size_t playerCount);
+    size_t playerCount() const { return m_ratings.size(); }
+
+    const Rating &rating(size_t player) const { return m_ratings[player]; }
+
+    // players[i] placed ranks[i], lower is better, equal ranks are a draw
+    void addResult(const std::vector<int> &players, const std::vector<int> &ranks);
+
+private:
+    std::vector<Rating> m_ratings;
+};
+
+#endif // RATING_H
@@ -0,0 +1,120 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <QtGlobal>
+
+// On-disk format of match recordings.
+//
+// Everything is a fixed size record, written in host byte order
+// (so little endian, on everything we run on):
+//
+//   RecordingHeader
+//   RecordedName            * header.playerCount
+//   for each tick:
+//     FrameHeader
+//     PlayerRecord          * frame.playerCount
+//     MissileRecord         * frame.missileCount
+//   RecordingIndexEntry     * trailer.keyframeCount
+//   RecordingTrailer
+//
+// The index at the end holds the file offset of every KEYFRAME_INTERVAL'th
+// frame, so seeking only has to skip over a few frame headers.
+// It is written when the recording is finished, so if it is missing
+// (e.g. because the game crashed) readers rebuild it by scanning the frames.
+
+#define RECORDING_MAGIC 0x524d4f54 // "TOMR"
+#define RECORDING_TRAILER_MAGIC 0x58444e49 // "INDX"
+#define RECORDING_VERSION 3
+#define RECORDING_NAME_LENGTH 32
+#define KEYFRAME_INTERVAL 64
+
+#pragma pack(push, 1)
+
+// Snapshot of the values in parameters.h the match was played with
+struct RecordingParameters
+{
+    double missileMaxSpeed;
+    double accelerationForce;
+    qint32 accelerationCost;
+    qint32 missileCost;
+    qint32 seekingMissileCost;
+    qint32 mineCost;
+    qint32 missileDamage;
+    qint32 rotateCost;
+    qint32 rotateAmount;
+    qint32 startEnergy;
+    qint32 maxPlayers;
+    qint32 maxRounds;
+    qint32 seekingRetargetInterval;
+};
+
+struct RecordingHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint64 seed;
+    qint32 tickInterval;
+    quint32 playerCount;
+    RecordingParameters parameters;
+};
+
+struct RecordedName
+{
+    char name[RECORDING_NAME_LENGTH]; // UTF-8, zero padded
+};
+
+struct FrameHeader
+{
+    quint32 frame; // Counts from 0 across all rounds
+    quint16 round;
+    quint16 reserved;
+    quint32 tick; // Counts from 0 in each round
+    quint32 playerCount;
+    quint32 missileCount;
+    quint64 digest; // World::digest() after this tick
+};
+
+// Players are stored in id order
+struct PlayerRecord
+{
+    float x;
+    float y;
+    float velocityX;
+    float velocityY;
+    qint32 energy;
+    qint16 rotation; // degrees
+    quint8 alive;
+    quint8 command; // Command (see world.h) applied this tick
+};
+
+struct MissileRecord
+{
+    quint32 id;
+    float x;
+    float y;
+    float velocityX;
+    float velocityY;
+    float rotation; // radians
+    qint32 energy;
+    quint16 owner;
+    quint8 type; // MissileType
+    quint8 reserved;
+};
+
+struct RecordingIndexEntry
+{
+    quint64 offset; // Offset of the FrameHeader from the start of the file
+};
+
+struct RecordingTrailer
+{
+    quint64 indexOffset;
+    quint32 frameCount;
+    quint32 keyframeInterval;
+    quint32 keyframeCount;
+    quint32 magic;
+};
+
+#pragma pack(pop)
+
+#endif // RECORDING_H
@@ -0,0 +1,231 @@
+#include "replay.h"
+
+#include <QDebug>
+
+Replay::Replay() :
+    m_data(nullptr),
+    m_size(0),
+    m_framesStart(0),
+    m_framesEnd(0),
+    m_header(nullptr),
+    m_frameCount(0),
+    m_keyframeInterval(KEYFRAME_INTERVAL),
+    m_cachedIndex(-1),
+    m_cachedOffset(0)
+{
+}
+
+Replay::~Replay()
+{
+    close();
+}
+
+bool Replay::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < sizeof(RecordingHeader)) {
+        m_errorString = "File is too small to be a recording";
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        m_errorString = m_file.errorString();
+        close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<const RecordingHeader*>(m_data);
+    if (m_header->magic != RECORDING_MAGIC) {
+        m_errorString = "Not a recording";
+        close();
+        return false;
+    }
+
+    if (m_header->version != RECORDING_VERSION) {
+        m_errorString = "Unsupported recording version " + QString::number(m_header->version);
+        close();
+        return false;
+    }
+
+    m_framesStart = sizeof(RecordingHeader) + quint64(m_header->playerCount) * sizeof(RecordedName);
+    if (m_framesStart > m_size) {
+        m_errorString = "Truncated recording";
+        close();
+        return false;
+    }
+
+    const RecordedName *names = reinterpret_cast<const RecordedName*>(m_data + sizeof(RecordingHeader));
+    for (quint32 i=0; i<m_header->playerCount; i++) {
+        m_playerNames.append(QString::fromUtf8(names[i].name, qstrnlen(names[i].name, RECORDING_NAME_LENGTH)));
+    }
+
+    if (!readIndex()) {
+        qWarning() << "Replay: no index in" << fileName << "probably not finished properly, scanning frames";
+        buildIndex();
+    }
+
+    return true;
+}
+
+void Replay::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+    m_file.close();
+
+    m_data = nullptr;
+    m_size = 0;
+    m_framesStart = 0;
+    m_framesEnd = 0;
+    m_header = nullptr;
+    m_playerNames.clear();
+    m_frameCount = 0;
+    m_keyframes.clear();
+    m_cachedIndex = -1;
+    m_cachedOffset = 0;
+}
+
+bool Replay::frame(int index, ReplayFrame *frame)
+{
+    if (index < 0 || index >= m_frameCount) {
+        return false;
+    }
+
+    int current;
+    quint64 offset;
+    if (m_cachedIndex >= 0 && m_cachedIndex <= index && index - m_cachedIndex < m_keyframeInterval) {
+        current = m_cachedIndex;
+        offset = m_cachedOffset;
+    } else {
+        const int keyframe = index / m_keyframeInterval;
+        current = keyframe * m_keyframeInterval;
+        offset = m_keyframes[keyframe];
+    }
+
+    while (current < index) {
+        if (!isValidFrame(offset)) {
+            return false;
+        }
+
+        offset += frameSize(offset);
+        current++;
+    }
+
+    if (!isValidFrame(offset)) {
+        return false;
+    }
+
+    m_cachedIndex = index;
+    m_cachedOffset = offset;
+
+    frame->header = reinterpret_cast<const FrameHeader*>(m_data + offset);
+    frame->players = reinterpret_cast<const PlayerRecord*>(m_data + offset + sizeof(FrameHeader));
+    frame->missiles = reinterpret_cast<const MissileRecord*>(m_data + offset + sizeof(FrameHeader) + frame->header->playerCount * sizeof(PlayerRecord));
+
+    return true;
+}
+
+int Replay::firstDivergence(Replay &first, Replay &second)
+{
+    const int frameCount = qMin(first.frameCount(), second.frameCount());
+    for (int i=0; i<frameCount; i++) {
+        ReplayFrame firstFrame, secondFrame;
+        if (!first.frame(i, &firstFrame) || !second.frame(i, &secondFrame)) {
+            return i;
+        }
+
+        if (firstFrame.header->digest != secondFrame.header->digest) {
+            return i;
+        }
+    }
+
+    if (first.frameCount() != second.frameCount()) {
+        return frameCount;
+    }
+
+    return -1;
+}
+
+bool Replay::readIndex()
+{
+    if (m_size < m_framesStart + sizeof(RecordingTrailer)) {
+        return false;
+    }
+
+    const RecordingTrailer *trailer = reinterpret_cast<const RecordingTrailer*>(m_data + m_size - sizeof(RecordingTrailer));
+    if (trailer->magic != RECORDING_TRAILER_MAGIC || trailer->keyframeInterval == 0) {
+        return false;
+    }
+
+    const quint64 indexSize = quint64(trailer->keyframeCount) * sizeof(RecordingIndexEntry);
+    if (trailer->indexOffset < m_framesStart || trailer->indexOffset + indexSize + sizeof(RecordingTrailer) != m_size) {
+        return false;
+    }
+
+    const quint32 expectedKeyframes = (trailer->frameCount + trailer->keyframeInterval - 1) / trailer->keyframeInterval;
+    if (trailer->keyframeCount != expectedKeyframes) {
+        return false;
+    }
+
+    m_framesEnd = trailer->indexOffset;
+    m_frameCount = trailer->frameCount;
+    m_keyframeInterval = trailer->keyframeInterval;
+
+    const RecordingIndexEntry *entries = reinterpret_cast<const RecordingIndexEntry*>(m_data + trailer->indexOffset);
+    m_keyframes.resize(trailer->keyframeCount);
+    for (quint32 i=0; i<trailer->keyframeCount; i++) {
+        m_keyframes[i] = entries[i].offset;
+    }
+
+    return true;
+}
+
+void Replay::buildIndex()
+{
+    m_framesEnd = m_size;
+    m_keyframeInterval = KEYFRAME_INTERVAL;
+    m_keyframes.clear();
+
+    quint64 offset = m_framesStart;
+    int count = 0;
+    while (isValidFrame(offset)) {
+        if (count % m_keyframeInterval == 0) {
+            m_keyframes.append(offset);
+        }
+
+        offset += frameSize(offset);
+        count++;
+    }
+
+    // Ignore whatever half-written frame might be at the end
+    m_framesEnd = offset;
+    m_frameCount = count;
+}
+
+bool Replay::isValidFrame(quint64 offset) const
+{
+    if (offset < m_framesStart || offset + sizeof(FrameHeader) > m_framesEnd) {
+        return false;
+    }
+
+    return offset + frameSize(offset) <= m_framesEnd;
+}
+
+quint64 Replay::frameSize(quint64 offset) const
+{
+    const FrameHeader *header = reinterpret_cast<const FrameHeader*>(m_data + offset);
+    return sizeof(FrameHeader) +
+            quint64(header->playerCount) * sizeof(PlayerRecord) +
+            quint64(header->missileCount) * sizeof(MissileRecord);
+}
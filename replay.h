@@ -0,0 +1,67 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "recording.h"
+
+struct ReplayFrame
+{
+    const FrameHeader *header;
+    const PlayerRecord *players;
+    const MissileRecord *missiles;
+};
+
+// Read-only, memory mapped view of a match recording
+class Replay
+{
+public:
+    Replay();
+    ~Replay();
+
+    bool open(const QString &fileName);
+    void close();
+
+    QString errorString() const { return m_errorString; }
+
+    const RecordingHeader &header() const { return *m_header; }
+    QStringList playerNames() const { return m_playerNames; }
+    int frameCount() const { return m_frameCount; }
+
+    // Looks up the closest keyframe, and then skips forward to the requested frame
+    bool frame(int index, ReplayFrame *frame);
+
+    // First frame where the state digests differ, or where one of them ends early.
+    // Returns -1 if the recordings are of identical matches.
+    static int firstDivergence(Replay &first, Replay &second);
+
+private:
+    bool readIndex();
+    void buildIndex();
+    bool isValidFrame(quint64 offset) const;
+    quint64 frameSize(quint64 offset) const;
+
+    QFile m_file;
+    const uchar *m_data;
+    quint64 m_size;
+    quint64 m_framesStart;
+    quint64 m_framesEnd;
+
+    const RecordingHeader *m_header;
+    QStringList m_playerNames;
+
+    int m_frameCount;
+    int m_keyframeInterval;
+    QVector<quint64> m_keyframes;
+
+    // Last frame looked up, so playing forwards doesn't need to go via the index
+    int m_cachedIndex;
+    quint64 m_cachedOffset;
+
+    QString m_errorString;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,143 @@
+#include "replayplayer.h"
+
+#include "parameters.h"
+
+#include <QDebug>
+
+#define MIN_REPLAY_SPEED 0.25
+#define MAX_REPLAY_SPEED 64.0
+
+ReplayPlayer::ReplayPlayer(QObject *parent) : QObject(parent),
+    m_frame(0),
+    m_speed(1),
+    m_framePosition(0)
+{
+    m_currentFrame.header = nullptr;
+    m_currentFrame.players = nullptr;
+    m_currentFrame.missiles = nullptr;
+
+    // Wake up often, and just skip as many frames as the speed says we should
+    m_timer.setInterval(16);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setSingleShot(false);
+
+    connect(&m_timer, &QTimer::timeout, this, &ReplayPlayer::advance);
+}
+
+bool ReplayPlayer::open(const QString &fileName)
+{
+    if (!m_replay.open(fileName)) {
+        return false;
+    }
+
+    if (m_replay.frameCount() == 0) {
+        qWarning() << "ReplayPlayer: no frames in" << fileName;
+    }
+
+    seek(0);
+    return true;
+}
+
+int ReplayPlayer::roundCount()
+{
+    ReplayFrame lastFrame;
+    if (!m_replay.frame(m_replay.frameCount() - 1, &lastFrame)) {
+        return 0;
+    }
+
+    return lastFrame.header->round + 1;
+}
+
+void ReplayPlayer::setSpeed(qreal speed)
+{
+    speed = qBound(MIN_REPLAY_SPEED, speed, MAX_REPLAY_SPEED);
+    if (qFuzzyCompare(speed, m_speed)) {
+        return;
+    }
+
+    m_speed = speed;
+    emit speedChanged();
+}
+
+void ReplayPlayer::seek(int frame)
+{
+    frame = qBound(0, frame, m_replay.frameCount() - 1);
+
+    ReplayFrame replayFrame;
+    if (!m_replay.frame(frame, &replayFrame)) {
+        return;
+    }
+
+    m_currentFrame = replayFrame;
+    m_frame = frame;
+    m_framePosition = frame;
+    emit frameChanged();
+}
+
+void ReplayPlayer::play()
+{
+    if (isPlaying()) {
+        return;
+    }
+
+    // Start over if we're at the end
+    if (m_frame >= m_replay.frameCount() - 1) {
+        seek(0);
+    }
+
+    m_clock.start();
+    m_timer.start();
+    emit playingChanged();
+}
+
+void ReplayPlayer::pause()
+{
+    if (!isPlaying()) {
+        return;
+    }
+
+    m_timer.stop();
+    emit playingChanged();
+}
+
+void ReplayPlayer::togglePlaying()
+{
+    if (isPlaying()) {
+        pause();
+    } else {
+        play();
+    }
+}
+
+void ReplayPlayer::faster()
+{
+    setSpeed(m_speed * 2);
+}
+
+void ReplayPlayer::slower()
+{
+    setSpeed(m_speed / 2);
+}
+
+void ReplayPlayer::advance()
+{
+    int tickInterval = m_replay.header().tickInterval;
+    if (tickInterval <= 0) {
+        tickInterval = DEFAULT_TICKINTERVAL;
+    }
+
+    const qreal framePosition = m_framePosition + m_clock.restart() * m_speed / tickInterval;
+
+    if (framePosition >= m_replay.frameCount() - 1) {
+        seek(m_replay.frameCount() - 1);
+        pause();
+        return;
+    }
+
+    if (int(framePosition) != m_frame) {
+        seek(int(framePosition));
+    }
+
+    // seek() resets the position to a whole frame, keep the fraction for smooth slow motion
+    m_framePosition = framePosition;
+}
@@ -0,0 +1,72 @@
+#ifndef REPLAYPLAYER_H
+#define REPLAYPLAYER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "replay.h"
+
+// Plays back a recorded match, at anything from a quarter to 64 times the original speed
+class ReplayPlayer : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int frame READ frame WRITE seek NOTIFY frameChanged)
+    Q_PROPERTY(int frameCount READ frameCount CONSTANT)
+    Q_PROPERTY(int round READ round NOTIFY frameChanged)
+    Q_PROPERTY(int tick READ tick NOTIFY frameChanged)
+    Q_PROPERTY(qreal speed READ speed WRITE setSpeed NOTIFY speedChanged)
+    Q_PROPERTY(bool playing READ isPlaying NOTIFY playingChanged)
+
+public:
+    explicit ReplayPlayer(QObject *parent = 0);
+
+    bool open(const QString &fileName);
+    QString errorString() const { return m_replay.errorString(); }
+
+    QStringList playerNames() const { return m_replay.playerNames(); }
+    const RecordingHeader &header() const { return m_replay.header(); }
+
+    int frame() { return m_frame; }
+    int frameCount() { return m_replay.frameCount(); }
+    const ReplayFrame &currentFrame() const { return m_currentFrame; }
+    int round() { return m_currentFrame.header ? m_currentFrame.header->round : 0; }
+    int tick() { return m_currentFrame.header ? m_currentFrame.header->tick : 0; }
+
+    // Number of rounds in the recording
+    int roundCount();
+
+    qreal speed() { return m_speed; }
+    void setSpeed(qreal speed);
+
+    bool isPlaying() { return m_timer.isActive(); }
+
+public slots:
+    void seek(int frame);
+    void play();
+    void pause();
+    void togglePlaying();
+    void faster();
+    void slower();
+
+signals:
+    void frameChanged();
+    void speedChanged();
+    void playingChanged();
+
+private slots:
+    void advance();
+
+private:
+    Replay m_replay;
+    ReplayFrame m_currentFrame;
+    int m_frame;
+
+    qreal m_speed;
+    qreal m_framePosition;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+};
+
+#endif // REPLAYPLAYER_H
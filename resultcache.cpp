@@ -0,0 +1,117 @@
+#include "resultcache.h"
+
+#include "bot.h"
+#include "world.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonDocument>
+
+#include <memory>
+
+ResultCache::ResultCache()
+{
+}
+
+bool ResultCache::open(const QString &fileName)
+{
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qWarning() << "ResultCache: unable to open" << fileName << m_file.errorString();
+        return false;
+    }
+
+    m_file.seek(0);
+    while (!m_file.atEnd()) {
+        const QJsonObject entry = QJsonDocument::fromJson(m_file.readLine()).object();
+        const QByteArray key = entry["key"].toString().toLatin1();
+        if (key.isEmpty()) {
+            continue; // Half written line from a crash
+        }
+        m_results.insert(key, MatchAssignmentResult::fromJson(entry["result"].toObject()));
+    }
+    m_file.seek(m_file.size());
+
+    qDebug() << "ResultCache: loaded" << m_results.count() << "results from" << fileName;
+    return true;
+}
+
+bool ResultCache::lookup(const MatchAssignment &assignment, MatchAssignmentResult *result)
+{
+    const auto it = m_results.constFind(key(assignment));
+    if (it == m_results.constEnd()) {
+        return false;
+    }
+
+    *result = it.value();
+    result->id = assignment.id;
+    result->bots = assignment.bots;
+    return true;
+}
+
+void ResultCache::insert(const MatchAssignment &assignment, const MatchAssignmentResult &result)
+{
+    if (!result.error.isEmpty()) {
+        return; // Might work next time
+    }
+
+    const QByteArray matchKey = key(assignment);
+    m_results.insert(matchKey, result);
+
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    QJsonObject entry;
+    entry["key"] = QString::fromLatin1(matchKey);
+    entry["result"] = result.toJson();
+    m_file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n');
+    m_file.flush();
+}
+
+QByteArray ResultCache::key(const MatchAssignment &assignment)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(quint64(rulesetHash())));
+    hash.addData(" " + QByteArray::number(assignment.seed));
+    hash.addData(" " + QByteArray::number(assignment.rounds));
+    hash.addData(" " + QByteArray::number(assignment.tickInterval));
+
+    // The order matters, it decides the starting positions
+    for (const QString &bot : assignment.bots) {
+        hash.addData(" " + botIdentity(bot));
+    }
+
+    return hash.result().toHex();
+}
+
+QByteArray ResultCache::botIdentity(const QString &bot)
+{
+    const auto it = m_identities.constFind(bot);
+    if (it != m_identities.constEnd()) {
+        return it.value();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(bot.toUtf8());
+
+    std::unique_ptr<Bot> builtin(createBot(bot.toStdString(), 0));
+    if (builtin) {
+        hash.addData(" builtin " + QByteArray::number(BUILTIN_BOTS_VERSION));
+    } else {
+        // Any file in the command line, the script or binary and whatever it is given
+        for (const QString &argument : bot.split(' ', QString::SkipEmptyParts)) {
+            QFile file(argument);
+            if (!QFileInfo(argument).isFile() || !file.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            hash.addData(" " + argument.toUtf8() + " ");
+            hash.addData(&file);
+        }
+    }
+
+    const QByteArray identity = hash.result().toHex();
+    m_identities.insert(bot, identity);
+    return identity;
+}
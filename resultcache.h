@@ -0,0 +1,40 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "tournament.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+// Results of matches that have already been played, stored on disk as one
+// line of JSON per match. A match is identified by a hash of the bots
+// (the contents of their files, for bot programs), the seed, the rounds,
+// the tick interval and the rules in parameters.h, so changing any of those
+// means the match gets played again.
+class ResultCache
+{
+public:
+    ResultCache();
+
+    bool open(const QString &fileName);
+
+    bool lookup(const MatchAssignment &assignment, MatchAssignmentResult *result);
+    void insert(const MatchAssignment &assignment, const MatchAssignmentResult &result);
+
+    int count() const { return m_results.count(); }
+
+    QByteArray key(const MatchAssignment &assignment);
+
+private:
+    QByteArray botIdentity(const QString &bot);
+
+    QFile m_file;
+    QHash<QByteArray, MatchAssignmentResult> m_results;
+
+    // Hashing the bot files again for every match is a waste
+    QHash<QString, QByteArray> m_identities;
+};
+
+#endif // RESULTCACHE_H
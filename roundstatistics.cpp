@@ -0,0 +1,158 @@
+#include "roundstatistics.h"
+
+#include "player.h"
+#include "world.h"
+
+#include <QJsonArray>
+
+#include <algorithm>
+
+RoundStatistics::RoundStatistics() :
+    m_ticks(0)
+{
+}
+
+void RoundStatistics::start(const World &world)
+{
+    const std::vector<ShipState> &ships = world.ships();
+
+    m_players.clear();
+    m_players.resize(ships.size());
+    for (size_t i=0; i<ships.size(); i++) {
+        PlayerStatistics &player = m_players[i];
+        player.hits = 0;
+        player.hitsTaken = 0;
+        player.normalShots = 0;
+        player.seekingShots = 0;
+        player.mines = 0;
+        player.energyStart = ships[i].energy;
+        player.energyMin = ships[i].energy;
+        player.energyMax = ships[i].energy;
+        player.energySum = 0;
+        player.energyEnd = ships[i].energy;
+        player.survivalTicks = 0;
+        player.survived = ships[i].alive;
+    }
+
+    m_ticks = 0;
+}
+
+void RoundStatistics::addTick(const World &world)
+{
+    const std::vector<ShipState> &ships = world.ships();
+    const std::vector<uint8_t> &commands = world.appliedCommands();
+    const int playerCount = qMin<int>(m_players.count(), ships.size());
+
+    m_ticks++;
+
+    for (int i=0; i<playerCount; i++) {
+        PlayerStatistics &player = m_players[i];
+        const ShipState &ship = ships[i];
+
+        if (ship.alive) {
+            player.survivalTicks++;
+        }
+        player.survived = ship.alive;
+
+        player.energyMin = qMin(player.energyMin, ship.energy);
+        player.energyMax = qMax(player.energyMax, ship.energy);
+        player.energySum += ship.energy;
+        player.energyEnd = ship.energy;
+
+        if (size_t(i) >= commands.size()) {
+            continue;
+        }
+
+        switch (commands[i]) {
+        case CommandMissile:
+            player.normalShots++;
+            break;
+        case CommandSeeking:
+            player.seekingShots++;
+            break;
+        case CommandMine:
+            player.mines++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (const Hit &hit : world.hits()) {
+        if (hit.owner < playerCount) {
+            m_players[hit.owner].hits++;
+        }
+        if (hit.ship < playerCount) {
+            m_players[hit.ship].hitsTaken++;
+        }
+    }
+}
+
+void RoundStatistics::addLatencies(int player, const QVector<qint64> &microseconds)
+{
+    if (player < 0 || player >= m_players.count()) {
+        return;
+    }
+
+    m_players[player].latencies += microseconds;
+}
+
+QJsonObject RoundStatistics::toJson(int round, quint64 seed, const QList<Player*> &players) const
+{
+    QJsonArray playersArray;
+    for (int i=0; i<m_players.count(); i++) {
+        const PlayerStatistics &statistics = m_players[i];
+
+        QJsonObject shots;
+        shots["normal"] = statistics.normalShots;
+        shots["seeking"] = statistics.seekingShots;
+        shots["mine"] = statistics.mines;
+
+        QJsonObject energy;
+        energy["start"] = statistics.energyStart;
+        energy["min"] = statistics.energyMin;
+        energy["max"] = statistics.energyMax;
+        energy["mean"] = m_ticks > 0 ? double(statistics.energySum) / m_ticks : statistics.energyStart;
+        energy["end"] = statistics.energyEnd;
+
+        QJsonObject latency;
+        latency["count"] = statistics.latencies.count();
+        if (!statistics.latencies.isEmpty()) {
+            QVector<qint64> sorted = statistics.latencies;
+            std::sort(sorted.begin(), sorted.end());
+
+            qint64 sum = 0;
+            for (qint64 value : sorted) {
+                sum += value;
+            }
+
+            latency["meanMs"] = sum / 1000.0 / sorted.count();
+            latency["medianMs"] = sorted[sorted.count() / 2] / 1000.0;
+            latency["p95Ms"] = sorted[qMin(sorted.count() - 1, sorted.count() * 95 / 100)] / 1000.0;
+            latency["maxMs"] = sorted.last() / 1000.0;
+        }
+
+        QJsonObject playerObject;
+        playerObject["id"] = i;
+        if (i < players.count()) {
+            playerObject["name"] = players[i]->name();
+            playerObject["wins"] = players[i]->wins();
+            playerObject["score"] = players[i]->score();
+        }
+        playerObject["survived"] = statistics.survived;
+        playerObject["survivalTicks"] = statistics.survivalTicks;
+        playerObject["hits"] = statistics.hits;
+        playerObject["hitsTaken"] = statistics.hitsTaken;
+        playerObject["shots"] = shots;
+        playerObject["energy"] = energy;
+        playerObject["latency"] = latency;
+        playersArray.append(playerObject);
+    }
+
+    QJsonObject roundObject;
+    roundObject["round"] = round;
+    roundObject["seed"] = QString::number(seed); // Doesn't fit in a double
+    roundObject["ticks"] = m_ticks;
+    roundObject["players"] = playersArray;
+    return roundObject;
+}
@@ -0,0 +1,50 @@
+#ifndef ROUNDSTATISTICS_H
+#define ROUNDSTATISTICS_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QVector>
+
+class World;
+class Player;
+
+// Collects what each player did during a round, for the results stream
+class RoundStatistics
+{
+public:
+    RoundStatistics();
+
+    void start(const World &world);
+
+    // Call after every step of the world
+    void addTick(const World &world);
+
+    // Time from a state update being sent until the player answered
+    void addLatencies(int player, const QVector<qint64> &microseconds);
+
+    // One record for the results stream, wins and score are the totals for the game so far
+    QJsonObject toJson(int round, quint64 seed, const QList<Player*> &players) const;
+
+private:
+    struct PlayerStatistics
+    {
+        int hits;
+        int hitsTaken;
+        int normalShots;
+        int seekingShots;
+        int mines;
+        int energyStart;
+        int energyMin;
+        int energyMax;
+        qint64 energySum;
+        int energyEnd;
+        int survivalTicks;
+        bool survived;
+        QVector<qint64> latencies;
+    };
+
+    QVector<PlayerStatistics> m_players;
+    int m_ticks;
+};
+
+#endif // ROUNDSTATISTICS_H
@@ -0,0 +1,186 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+// Stop when no rating is more uncertain than this
+#define CONVERGED_SIGMA 1.0
+
+TournamentScheduler::TournamentScheduler(const std::vector<std::string> &bots, int groupSize, int rounds, uint64_t seed) :
+    m_bots(bots),
+    m_groupSize(std::min<int>(groupSize, bots.size())),
+    m_rounds(rounds),
+    m_nextSeed(seed),
+    m_random(seed),
+    m_ratings(bots.size()),
+    m_matchesPlayed(0)
+{
+    // Tell apart the copies of the same bot
+    std::map<std::string, int> counts;
+    for (const std::string &bot : bots) {
+        counts[bot]++;
+    }
+
+    std::map<std::string, int> seen;
+    for (const std::string &bot : bots) {
+        if (counts[bot] > 1) {
+            m_names.push_back(bot + '#' + std::to_string(++seen[bot]));
+        } else {
+            m_names.push_back(bot);
+        }
+    }
+}
+
+std::vector<MatchConfig> TournamentScheduler::nextMatches(int count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<MatchConfig> matches;
+    if (m_groupSize < 2) {
+        return matches;
+    }
+
+    // The most uncertain get to pick their opponents first
+    std::vector<int> order(m_bots.size());
+    for (size_t i=0; i<order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_ratings.rating(a).sigma > m_ratings.rating(b).sigma;
+    });
+
+    // Spread the matches over the whole pool
+    const int maxUses = std::max<int>(1, (count * m_groupSize + m_bots.size() - 1) / m_bots.size());
+    std::vector<int> uses(m_bots.size(), 0);
+
+    for (size_t i=0; int(matches.size()) < count; i = (i + 1) % order.size()) {
+        const int anchor = order[i];
+        if (uses[anchor] >= maxUses) {
+            if (std::all_of(uses.begin(), uses.end(), [maxUses](int used) { return used >= maxUses; })) {
+                break;
+            }
+            continue;
+        }
+
+        const std::vector<int> group = pickGroup(anchor, uses, maxUses);
+        if (int(group.size()) < m_groupSize) {
+            break;
+        }
+
+        MatchConfig config;
+        config.seed = m_nextSeed++;
+        config.rounds = m_rounds;
+        config.maxTicks = 10000;
+        for (int bot : group) {
+            config.bots.push_back(m_bots[bot]);
+            uses[bot]++;
+        }
+
+        m_scheduled[config.seed] = group;
+        matches.push_back(config);
+    }
+
+    return matches;
+}
+
+std::vector<int> TournamentScheduler::pickGroup(int anchor, const std::vector<int> &uses, int maxUses)
+{
+    // Close in skill, and uncertain, with a bit of randomness so the same groups don't repeat
+    const Rating &anchorRating = m_ratings.rating(anchor);
+    std::vector<std::pair<double, int>> candidates;
+    for (size_t i=0; i<m_bots.size(); i++) {
+        if (int(i) == anchor || uses[i] >= maxUses) {
+            continue;
+        }
+
+        const Rating &rating = m_ratings.rating(i);
+        const double distance = std::abs(rating.mu - anchorRating.mu);
+        const double noise = m_random.bounded(1000) / 1000.0;
+        candidates.push_back(std::make_pair(distance - rating.sigma - noise * anchorRating.sigma, int(i)));
+    }
+
+    const size_t needed = std::min<size_t>(m_groupSize - 1, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + needed, candidates.end());
+
+    std::vector<int> group;
+    group.push_back(anchor);
+    for (size_t i=0; i<needed; i++) {
+        group.push_back(candidates[i].second);
+    }
+    return group;
+}
+
+void TournamentScheduler::addResult(const MatchResult &result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_scheduled.find(result.seed);
+    if (it == m_scheduled.end()) {
+        return;
+    }
+    const std::vector<int> players = it->second;
+    m_scheduled.erase(it);
+
+    // Placed by wins, then score, the same way as the scoreboard
+    std::vector<int> order(players.size());
+    for (size_t i=0; i<order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&result](int a, int b) {
+        if (result.wins[a] != result.wins[b]) {
+            return result.wins[a] > result.wins[b];
+        }
+        return result.scores[a] > result.scores[b];
+    });
+
+    std::vector<int> ranks(players.size());
+    for (size_t i=0; i<order.size(); i++) {
+        const int current = order[i];
+        if (i > 0) {
+            const int previous = order[i - 1];
+            if (result.wins[current] == result.wins[previous] && result.scores[current] == result.scores[previous]) {
+                ranks[current] = ranks[previous];
+                continue;
+            }
+        }
+        ranks[current] = i;
+    }
+
+    m_ratings.addResult(players, ranks);
+    m_matchesPlayed++;
+}
+
+bool TournamentScheduler::hasConverged() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (size_t i=0; i<m_ratings.playerCount(); i++) {
+        if (m_ratings.rating(i).sigma > CONVERGED_SIGMA) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int TournamentScheduler::matchesPlayed() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_matchesPlayed;
+}
+
+std::vector<TournamentScheduler::Standing> TournamentScheduler::standings() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<Standing> standings;
+    for (size_t i=0; i<m_names.size(); i++) {
+        Standing standing;
+        standing.name = m_names[i];
+        standing.rating = m_ratings.rating(i);
+        standings.push_back(standing);
+    }
+
+    std::sort(standings.begin(), standings.end(), [](const Standing &a, const Standing &b) {
+        return a.rating.conservative() > b.rating.conservative();
+    });
+    return standings;
+}
@@ -0,0 +1,59 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "match.h"
+#include "rating.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Picks which bots from a pool should play each other next, and keeps their
+// ratings up to date as the results come in. It prefers groups of bots that
+// are uncertain and close to each other in skill, since that is where a
+// match tells us the most.
+class TournamentScheduler
+{
+public:
+    // bots are built in bot types, the same type can be in the pool several times
+    TournamentScheduler(const std::vector<std::string> &bots, int groupSize, int rounds, uint64_t seed);
+
+    // Up to count matches to play next
+    std::vector<MatchConfig> nextMatches(int count);
+
+    // Safe to call from the MatchRunner threads
+    void addResult(const MatchResult &result);
+
+    // True when everyone's rating is certain enough
+    bool hasConverged() const;
+
+    int matchesPlayed() const;
+
+    // Best first, by conservative rating
+    struct Standing
+    {
+        std::string name;
+        Rating rating;
+    };
+    std::vector<Standing> standings() const;
+
+private:
+    std::vector<int> pickGroup(int anchor, const std::vector<int> &uses, int maxUses);
+
+    std::vector<std::string> m_bots;
+    std::vector<std::string> m_names;
+    int m_groupSize;
+    int m_rounds;
+    uint64_t m_nextSeed;
+    Pcg32 m_random;
+
+    // Which bots are playing in the match with this seed
+    std::map<uint64_t, std::vector<int>> m_scheduled;
+
+    mutable std::mutex m_mutex;
+    RatingTable m_ratings;
+    int m_matchesPlayed;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,171 @@
+#include "scoreboard.h"
+
+#include "player.h"
+
+#include <algorithm>
+
+Scoreboard::Scoreboard(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+int Scoreboard::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return m_players.count();
+}
+
+QVariant Scoreboard::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_players.count()) {
+        return QVariant();
+    }
+
+    Player *player = m_players[index.row()];
+    switch (role) {
+    case PlayerRole:
+        return QVariant::fromValue<QObject*>(player);
+    case Qt::DisplayRole:
+    case NameRole:
+        return player->name();
+    case WinsRole:
+        return player->wins();
+    case ScoreRole:
+        return player->score();
+    case AliveRole:
+        return player->isAlive();
+    case EnergyRole:
+        return player->energy();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> Scoreboard::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[PlayerRole] = "player";
+    roles[NameRole] = "name";
+    roles[WinsRole] = "wins";
+    roles[ScoreRole] = "score";
+    roles[AliveRole] = "alive";
+    roles[EnergyRole] = "energy";
+    return roles;
+}
+
+void Scoreboard::addPlayer(Player *player)
+{
+    // After everyone as good, so new players with the same score end up last
+    const int row = std::upper_bound(m_players.begin(), m_players.end(), player, Player::comparePlayers) - m_players.begin();
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_players.insert(row, player);
+    updateRows(row, m_players.count() - 1);
+    endInsertRows();
+
+    connect(player, &Player::winsChanged, this, &Scoreboard::onRankChanged);
+    connect(player, &Player::scoreChanged, this, &Scoreboard::onRankChanged);
+    connect(player, &Player::nameChanged, this, &Scoreboard::onNameChanged);
+    connect(player, &Player::aliveChanged, this, &Scoreboard::onAliveChanged);
+    connect(player, &Player::energyChanged, this, &Scoreboard::onEnergyChanged);
+
+    emit countChanged();
+}
+
+void Scoreboard::removePlayer(Player *player)
+{
+    if (!m_rows.contains(player)) {
+        return;
+    }
+    const int row = m_rows.take(player);
+
+    disconnect(player, nullptr, this, nullptr);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_players.remove(row);
+    updateRows(row, m_players.count() - 1);
+    endRemoveRows();
+
+    emit countChanged();
+}
+
+void Scoreboard::clear()
+{
+    if (m_players.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    for (Player *player : m_players) {
+        disconnect(player, nullptr, this, nullptr);
+    }
+    m_players.clear();
+    m_rows.clear();
+    endResetModel();
+
+    emit countChanged();
+}
+
+void Scoreboard::onRankChanged()
+{
+    Player *player = qobject_cast<Player*>(sender());
+    if (!m_rows.contains(player)) {
+        return;
+    }
+    const int row = m_rows.value(player);
+
+    // Everything else is still in order, so it only has to bubble up or down to its new place
+    int newRow = row;
+    while (newRow > 0 && Player::comparePlayers(player, m_players[newRow - 1])) {
+        newRow--;
+    }
+    while (newRow < m_players.count() - 1 && Player::comparePlayers(m_players[newRow + 1], player)) {
+        newRow++;
+    }
+
+    if (newRow != row) {
+        // The destination is counted before the row is taken out
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), newRow > row ? newRow + 1 : newRow);
+        m_players.remove(row);
+        m_players.insert(newRow, player);
+        updateRows(qMin(row, newRow), qMax(row, newRow));
+        endMoveRows();
+    }
+
+    const QModelIndex changed = index(newRow);
+    emit dataChanged(changed, changed, { WinsRole, ScoreRole });
+}
+
+void Scoreboard::onNameChanged()
+{
+    emitDataChanged(qobject_cast<Player*>(sender()), NameRole);
+}
+
+void Scoreboard::onAliveChanged()
+{
+    emitDataChanged(qobject_cast<Player*>(sender()), AliveRole);
+}
+
+void Scoreboard::onEnergyChanged()
+{
+    emitDataChanged(qobject_cast<Player*>(sender()), EnergyRole);
+}
+
+void Scoreboard::emitDataChanged(Player *player, int role)
+{
+    if (!m_rows.contains(player)) {
+        return;
+    }
+
+    const QModelIndex changed = index(m_rows.value(player));
+    emit dataChanged(changed, changed, { role });
+}
+
+void Scoreboard::updateRows(int from, int to)
+{
+    for (int row=from; row<=to; row++) {
+        m_rows[m_players[row]] = row;
+    }
+}
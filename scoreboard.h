@@ -0,0 +1,63 @@
+#ifndef SCOREBOARD_H
+#define SCOREBOARD_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QHash>
+
+class Player;
+
+// The players in order of wins, and then score. Keeps the order up to date as
+// the scores change by moving single rows, so views only move the delegates
+// that changed place instead of building all of them again.
+class Scoreboard : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        PlayerRole = Qt::UserRole + 1,
+        NameRole,
+        WinsRole,
+        ScoreRole,
+        AliveRole,
+        EnergyRole
+    };
+
+    explicit Scoreboard(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_players.count(); }
+
+    // Best first
+    const QVector<Player*> &ranking() const { return m_players; }
+
+    void addPlayer(Player *player);
+    void removePlayer(Player *player);
+    void clear();
+
+signals:
+    void countChanged();
+
+private slots:
+    void onRankChanged();
+    void onNameChanged();
+    void onAliveChanged();
+    void onEnergyChanged();
+
+private:
+    void emitDataChanged(Player *player, int role);
+    void updateRows(int from, int to);
+
+    QVector<Player*> m_players;
+
+    // Where each player is in m_players, so a change doesn't need a search through everyone
+    QHash<Player*, int> m_rows;
+};
+
+#endif // SCOREBOARD_H
@@ -1,29 +1,129 @@
 #include "settings.h"
 #include <QSettings>
+#include <QMetaEnum>
+#include <QRunnable>
 #include <QDebug>
 
+// How long to wait after a change before writing, so a burst of them only gets written once
+#define SETTINGS_SAVE_DELAY 500
+
+namespace {
+
+// Writes a batch of changed settings, on the writer thread
+class SettingsWriter : public QRunnable
+{
+public:
+    explicit SettingsWriter(const QHash<QString, QVariant> &values) : m_values(values) {}
+
+    void run() override
+    {
+        QSettings settings;
+        for (auto it = m_values.constBegin(); it != m_values.constEnd(); ++it) {
+            settings.setValue(it.key(), it.value());
+        }
+        settings.sync();
+
+        if (settings.status() != QSettings::NoError) {
+            qWarning() << "Settings: unable to save to" << settings.fileName();
+        }
+    }
+
+private:
+    QHash<QString, QVariant> m_values;
+};
+
+}
+
 Settings::Settings(QObject *parent) : QObject(parent)
 {
+    // Only one thread, so the batches are written in order
+    m_writer.setMaxThreadCount(1);
+
+    m_saveTimer.setInterval(SETTINGS_SAVE_DELAY);
+    m_saveTimer.setSingleShot(true);
+    connect(&m_saveTimer, &QTimer::timeout, this, &Settings::save);
+
+    const QMetaEnum keys = QMetaEnum::fromType<Key>();
+
+    QSettings settings;
+    for (int i=0; i<keys.keyCount(); i++) {
+        const Key key = Key(keys.value(i));
+        const QVariant fallback = defaultValue(key);
+
+        // QSettings doesn't store type info, and returns e.g. stored bools as
+        // strings, which Javascript would treat as true even when it's "false"
+        QVariant value = settings.value(keyName(key), fallback);
+        if (!value.convert(fallback.userType())) {
+            value = fallback;
+        }
+
+        m_values[key] = value;
+    }
+}
+
+Settings::~Settings()
+{
+    // We're going away, so we have to wait for everything to be written
+    save();
+    m_writer.waitForDone();
 }
 
 void Settings::setValue(Key key, QVariant value)
 {
-    QSettings settings;
-    settings.setValue(QVariant::fromValue(key).toString(), value);
+    const QVariant fallback = defaultValue(key);
+    if (fallback.isValid() && !value.convert(fallback.userType())) {
+        qWarning() << "Settings: invalid value for" << keyName(key) << value;
+        return;
+    }
+
+    if (m_values.value(key) == value) {
+        return;
+    }
+
+    m_values[key] = value;
+    m_changed[key] = value;
+    m_saveTimer.start();
+
+    switch (key) {
+    case EnableEffects:
+        emit enableEffectsChanged();
+        break;
+    }
 }
 
 QVariant Settings::getValue(Settings::Key key, QVariant defaultValue)
 {
-    QSettings settings;
-    QVariant value = settings.value(QVariant::fromValue(key).toString(), defaultValue);
+    return m_values.value(key, defaultValue);
+}
+
+void Settings::save()
+{
+    m_saveTimer.stop();
 
-    // Ugly hack because QSettings doesn't store type info,
-    // and returns stored bools as strings.
-    // Javascript in turn implicitly converts all non-empty strings to boolean true
-    // Fuck you very much
-    if (value.toString() == "true" || value.toString() == "false") {
-        return value.toBool();
+    if (m_changed.isEmpty()) {
+        return;
     }
 
-    return value;
+    QHash<QString, QVariant> values;
+    for (auto it = m_changed.constBegin(); it != m_changed.constEnd(); ++it) {
+        values[keyName(Key(it.key()))] = it.value();
+    }
+    m_changed.clear();
+
+    m_writer.start(new SettingsWriter(values));
+}
+
+QVariant Settings::defaultValue(Key key)
+{
+    switch (key) {
+    case EnableEffects:
+        return true;
+    }
+
+    return QVariant();
+}
+
+QString Settings::keyName(Key key)
+{
+    return QVariant::fromValue(key).toString();
 }
@@ -3,10 +3,19 @@
 
 #include <QObject>
 #include <QVariant>
+#include <QHash>
+#include <QTimer>
+#include <QThreadPool>
 
+// All settings are read once when created, and kept in memory with the right
+// types. Changes are written back on a background thread shortly after the
+// last one, so toggling things in the UI never waits for the disk.
 class Settings : public QObject
 {
     Q_OBJECT
+
+    Q_PROPERTY(bool enableEffects READ enableEffects WRITE setEnableEffects NOTIFY enableEffectsChanged)
+
 public:
     enum Key {
         EnableEffects
@@ -14,13 +23,29 @@ public:
     Q_ENUM(Key)
 
     explicit Settings(QObject *parent = 0);
+    ~Settings();
 
     Q_INVOKABLE void setValue(Key key, QVariant value);
     Q_INVOKABLE QVariant getValue(Key key, QVariant defaultValue);
 
+    bool enableEffects() const { return m_values.value(EnableEffects).toBool(); }
+    void setEnableEffects(bool enable) { setValue(EnableEffects, enable); }
+
 signals:
+    void enableEffectsChanged();
 
 public slots:
+    // Writes all changes now, instead of waiting
+    void save();
+
+private:
+    static QVariant defaultValue(Key key);
+    static QString keyName(Key key);
+
+    QHash<int, QVariant> m_values;
+    QHash<int, QVariant> m_changed;
+    QTimer m_saveTimer;
+    QThreadPool m_writer;
 };
 
 #endif // SETTINGS_H
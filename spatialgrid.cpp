@@ -0,0 +1,99 @@
+#include "spatialgrid.h"
+
+#include <utility>
+
+SpatialGrid::SpatialGrid(int cellsPerSide) :
+    m_cellsPerSide(std::max(cellsPerSide, 1)),
+    m_cellSize(2.0 / m_cellsPerSide),
+    m_cells(m_cellsPerSide * m_cellsPerSide)
+{
+}
+
+void SpatialGrid::clear()
+{
+    for (std::vector<Entry> &cell : m_cells) {
+        cell.clear();
+    }
+}
+
+void SpatialGrid::reset(int cellsPerSide)
+{
+    cellsPerSide = std::max(cellsPerSide, 1);
+    if (cellsPerSide == m_cellsPerSide) {
+        clear();
+        return;
+    }
+
+    m_cellsPerSide = cellsPerSide;
+    m_cellSize = 2.0 / m_cellsPerSide;
+    m_cells.assign(m_cellsPerSide * m_cellsPerSide, std::vector<Entry>());
+}
+
+void SpatialGrid::insert(int index, double x, double y)
+{
+    Entry entry;
+    entry.index = index;
+    entry.x = x;
+    entry.y = y;
+    m_cells[cellFor(y) * m_cellsPerSide + cellFor(x)].push_back(entry);
+}
+
+void SpatialGrid::query(double x, double y, double radius, std::vector<int> *result) const
+{
+    forEachNear(x, y, radius, [result](const Entry &entry, double) {
+        result->push_back(entry.index);
+    });
+}
+
+void SpatialGrid::nearest(double x, double y, double radius, size_t count, std::vector<int> *result) const
+{
+    if (count == 0 || !(radius >= 0)) {
+        return;
+    }
+
+    // Nothing is further away than that, and an infinite radius would never be reached below
+    radius = std::min(radius, 2.0);
+
+    std::vector<std::pair<double, int>> found;
+    double searchRadius = std::min(radius, m_cellSize * 2);
+    for (;;) {
+        found.clear();
+        forEachNear(x, y, searchRadius, [&found](const Entry &entry, double entryDistance) {
+            found.push_back(std::make_pair(entryDistance, entry.index));
+        });
+
+        if (found.size() >= count || searchRadius >= radius) {
+            break;
+        }
+        searchRadius = std::min(searchRadius * 2, radius);
+    }
+
+    if (found.size() > count) {
+        std::nth_element(found.begin(), found.begin() + count, found.end());
+        found.resize(count);
+    }
+    std::sort(found.begin(), found.end());
+
+    for (const std::pair<double, int> &entry : found) {
+        result->push_back(entry.second);
+    }
+}
+
+double SpatialGrid::distance(double x1, double y1, double x2, double y2)
+{
+    double dx = std::fabs(x1 - x2);
+    double dy = std::fabs(y1 - y2);
+    if (dx > 1.0) {
+        dx = 2.0 - dx;
+    }
+    if (dy > 1.0) {
+        dy = 2.0 - dy;
+    }
+    return std::hypot(dx, dy);
+}
+
+int SpatialGrid::cellFor(double position) const
+{
+    const int cell = int(std::floor((position + 1.0) / m_cellSize));
+    return std::min(std::max(cell, 0), m_cellsPerSide - 1);
+}
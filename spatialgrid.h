@@ -0,0 +1,128 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Finds what is near a point in the game area without looking at everything.
+// The area goes from -1 to 1 on both axes and wraps around at the edges, like
+// the ships and missiles do, and is split into cells that each know what is in
+// them. Refill it whenever things have moved.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(int cellsPerSide = 32);
+
+    // Keeps the memory around, so refilling every tick doesn't allocate
+    void clear();
+
+    // Empties it, and splits the area up into a different number of cells
+    void reset(int cellsPerSide);
+    int cellsPerSide() const { return m_cellsPerSide; }
+
+    // The index is what the queries give back
+    void insert(int index, double x, double y);
+
+    // Appends the index of everything within radius of x, y
+    void query(double x, double y, double radius, std::vector<int> *result) const;
+
+    // Appends the index of the count nearest things within radius of x, y, nearest first.
+    // Starts looking close by, and only goes further out when it hasn't found enough.
+    void nearest(double x, double y, double radius, size_t count, std::vector<int> *result) const;
+
+    // The index of the nearest thing within radius that accept(index) is true for, or -1.
+    // Ties go to the lowest index.
+    template <typename Accept>
+    int nearest(double x, double y, double radius, Accept accept) const
+    {
+        int found = -1;
+        if (!(radius >= 0)) {
+            return found; // Also NaN
+        }
+        radius = std::min(radius, 2.0);
+
+        double foundDistance = 0;
+        double searchRadius = std::min(radius, m_cellSize * 2);
+        for (;;) {
+            forEachNear(x, y, searchRadius, [&](const Entry &entry, double entryDistance) {
+                if (found >= 0 && (entryDistance > foundDistance || (entryDistance == foundDistance && entry.index > found))) {
+                    return;
+                }
+                if (!accept(entry.index)) {
+                    return;
+                }
+                found = entry.index;
+                foundDistance = entryDistance;
+            });
+
+            // Anything nearer would have been inside the search radius as well
+            if (found >= 0 || searchRadius >= radius) {
+                return found;
+            }
+            searchRadius = std::min(searchRadius * 2, radius);
+        }
+    }
+
+    // The shortest way between two points, which may be across an edge
+    static double distance(double x1, double y1, double x2, double y2);
+
+private:
+    struct Entry
+    {
+        int index;
+        double x;
+        double y;
+    };
+
+    int cellFor(double position) const;
+
+    // Calls function(entry, distance) for everything within radius
+    template <typename Function>
+    void forEachNear(double x, double y, double radius, Function function) const
+    {
+        // Nothing is further away than the whole area, and a huge radius
+        // would overflow the cell numbers, so just look at every cell then
+        int firstColumn = 0;
+        int lastColumn = m_cellsPerSide - 1;
+        int firstRow = 0;
+        int lastRow = m_cellsPerSide - 1;
+        if (radius < 2.0) {
+            // The cells the circle touches, without wrapping yet
+            firstColumn = int(std::floor((x - radius + 1.0) / m_cellSize));
+            lastColumn = int(std::floor((x + radius + 1.0) / m_cellSize));
+            firstRow = int(std::floor((y - radius + 1.0) / m_cellSize));
+            lastRow = int(std::floor((y + radius + 1.0) / m_cellSize));
+        }
+
+        // Don't visit any cell twice when the circle reaches all the way around
+        if (lastColumn - firstColumn >= m_cellsPerSide) {
+            firstColumn = 0;
+            lastColumn = m_cellsPerSide - 1;
+        }
+        if (lastRow - firstRow >= m_cellsPerSide) {
+            firstRow = 0;
+            lastRow = m_cellsPerSide - 1;
+        }
+
+        for (int row=firstRow; row<=lastRow; row++) {
+            const int wrappedRow = ((row % m_cellsPerSide) + m_cellsPerSide) % m_cellsPerSide;
+            for (int column=firstColumn; column<=lastColumn; column++) {
+                const int wrappedColumn = ((column % m_cellsPerSide) + m_cellsPerSide) % m_cellsPerSide;
+                for (const Entry &entry : m_cells[wrappedRow * m_cellsPerSide + wrappedColumn]) {
+                    const double entryDistance = distance(x, y, entry.x, entry.y);
+                    if (entryDistance <= radius) {
+                        function(entry, entryDistance);
+                    }
+                }
+            }
+        }
+    }
+
+    int m_cellsPerSide;
+    double m_cellSize;
+    std::vector<std::vector<Entry>> m_cells;
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,171 @@
+#include "spatialgrid.h"
+#include "pcg32.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#define CHECK_ROUNDS 2000
+#define CHECK_MAX_POINTS 300
+#define CHECK_MAX_CELLS 40
+
+namespace {
+
+struct Point
+{
+    double x;
+    double y;
+};
+
+int s_failures = 0;
+
+void fail(const char *check, int round)
+{
+    if (s_failures < 20) {
+        printf("%s differs in round %d\n", check, round);
+    }
+    s_failures++;
+}
+
+double randomPosition(Pcg32 &random)
+{
+    // Now and then right on or next to an edge, where the wrapping happens
+    switch (random.bounded(8)) {
+    case 0:
+        return 1.0;
+    case 1:
+        return -1.0;
+    case 2:
+        return 0.999 + random.bounded(1000) / 1000000.0;
+    default:
+        return random.next() / 2147483648.0 - 1.0;
+    }
+}
+
+// Everything within radius, nearest first, ties by index
+std::vector<std::pair<double, int>> bruteForce(const std::vector<Point> &points, double x, double y, double radius)
+{
+    std::vector<std::pair<double, int>> found;
+    for (size_t i=0; i<points.size(); i++) {
+        const double distance = SpatialGrid::distance(x, y, points[i].x, points[i].y);
+        if (distance <= radius) {
+            found.push_back(std::make_pair(distance, int(i)));
+        }
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+void checkRound(Pcg32 &random, int round)
+{
+    std::vector<Point> points(random.bounded(CHECK_MAX_POINTS) + 1);
+    SpatialGrid grid(random.bounded(CHECK_MAX_CELLS) + 1);
+    for (size_t i=0; i<points.size(); i++) {
+        points[i].x = randomPosition(random);
+        points[i].y = randomPosition(random);
+        grid.insert(int(i), points[i].x, points[i].y);
+    }
+
+    const double x = randomPosition(random);
+    const double y = randomPosition(random);
+    const double radius = random.bounded(1500) / 1000.0;
+    const std::vector<std::pair<double, int>> expected = bruteForce(points, x, y, radius);
+
+    std::vector<int> result;
+    grid.query(x, y, radius, &result);
+    std::sort(result.begin(), result.end());
+    std::vector<int> expectedIndexes;
+    for (const std::pair<double, int> &entry : expected) {
+        expectedIndexes.push_back(entry.second);
+    }
+    std::sort(expectedIndexes.begin(), expectedIndexes.end());
+    if (result != expectedIndexes) {
+        fail("query", round);
+    }
+
+    // Only the distances have to match, points the same distance away can come in any order
+    const size_t count = random.bounded(8) + 1;
+    result.clear();
+    grid.nearest(x, y, radius, count, &result);
+    bool same = result.size() == std::min(count, expected.size());
+    for (size_t i=0; same && i<result.size(); i++) {
+        same = SpatialGrid::distance(x, y, points[result[i]].x, points[result[i]].y) == expected[i].first;
+    }
+    if (!same) {
+        fail("nearest", round);
+    }
+
+    // Like seeking missiles, skipping some
+    const int skipped = int(random.bounded(uint32_t(points.size())));
+    const int nearest = grid.nearest(x, y, radius, [skipped](int index) {
+        return index % 3 != 0 && index != skipped;
+    });
+    int expectedNearest = -1;
+    for (const std::pair<double, int> &entry : expected) {
+        if (entry.second % 3 != 0 && entry.second != skipped) {
+            expectedNearest = entry.second;
+            break;
+        }
+    }
+    if (nearest != expectedNearest) {
+        fail("nearest with filter", round);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    // Right across the edge from each other
+    SpatialGrid edges(32);
+    edges.insert(0, -0.99, 0.0);
+    edges.insert(1, 0.0, 0.99);
+    std::vector<int> result;
+    edges.query(0.99, 0.0, 0.05, &result);
+    if (result != std::vector<int>(1, 0)) {
+        fail("query across the edge", -1);
+    }
+    if (edges.nearest(0.0, -0.99, 0.05, [](int) { return true; }) != 1) {
+        fail("nearest across the edge", -1);
+    }
+
+    // Radii far bigger than the area, or infinite, find everything and still return
+    const double hugeRadii[] = { 2.0, 1e9, 1e300, std::numeric_limits<double>::infinity() };
+    for (double radius : hugeRadii) {
+        result.clear();
+        edges.query(0.5, 0.5, radius, &result);
+        if (result.size() != 2) {
+            fail("query with a huge radius", -1);
+        }
+        result.clear();
+        edges.nearest(0.5, 0.5, radius, 10, &result);
+        if (result.size() != 2) {
+            fail("nearest with a huge radius", -1);
+        }
+        if (edges.nearest(0.5, 0.5, radius, [](int index) { return index == 0; }) != 0) {
+            fail("nearest with filter and a huge radius", -1);
+        }
+    }
+
+    // Not a number finds nothing, but doesn't hang either
+    result.clear();
+    edges.nearest(0.5, 0.5, std::numeric_limits<double>::quiet_NaN(), 10, &result);
+    if (!result.empty() || edges.nearest(0.5, 0.5, std::numeric_limits<double>::quiet_NaN(), [](int) { return true; }) != -1) {
+        fail("nearest with NaN radius", -1);
+    }
+
+    Pcg32 random(1);
+    for (int round=0; round<CHECK_ROUNDS; round++) {
+        checkRound(random, round);
+    }
+
+    if (s_failures > 0) {
+        printf("%d differences\n", s_failures);
+        return 1;
+    }
+
+    printf("All %d rounds match\n", CHECK_ROUNDS);
+    return 0;
+}
@@ -0,0 +1,18 @@
+# Checks SpatialGrid against looking through everything, without Qt.
+# Build and run with qmake && make && ./spatialgridcheck, it exits with 1 on any difference.
+
+TEMPLATE = app
+TARGET = spatialgridcheck
+
+CONFIG += c++11 console
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    spatialgridcheck.cpp \
+    ../spatialgrid.cpp
+
+HEADERS += \
+    ../spatialgrid.h \
+    ../pcg32.h
@@ -0,0 +1,39 @@
+#ifndef STATEDIGEST_H
+#define STATEDIGEST_H
+
+#include <cstdint>
+#include <cstring>
+
+// Cheap 64 bit hash of the world state (FNV-1a over whole words), for checking
+// that two simulations of the same match haven't diverged. Not cryptographic.
+class StateDigest
+{
+public:
+    StateDigest() : m_hash(14695981039346656037ULL) {}
+
+    void addInteger(int64_t value)
+    {
+        m_hash ^= uint64_t(value);
+        m_hash *= 1099511628211ULL;
+        m_hash ^= m_hash >> 32;
+    }
+
+    // Hashes the exact bits, so any difference in rounding shows up
+    void addReal(double value)
+    {
+        if (value == 0) {
+            value = 0; // -0 == 0
+        }
+
+        int64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        addInteger(bits);
+    }
+
+    uint64_t value() const { return m_hash; }
+
+private:
+    uint64_t m_hash;
+};
+
+#endif // STATEDIGEST_H
@@ -0,0 +1,220 @@
+#include "tournament.h"
+
+#include "bot.h"
+#include "pcg32.h"
+
+#include <QCryptographicHash>
+#include <QJsonArray>
+
+#include <algorithm>
+#include <memory>
+
+static QJsonArray toJsonArray(const QVector<int> &values)
+{
+    QJsonArray array;
+    for (int value : values) {
+        array.append(value);
+    }
+    return array;
+}
+
+static QVector<int> fromJsonArray(const QJsonValue &value)
+{
+    QVector<int> values;
+    for (const QJsonValue &element : value.toArray()) {
+        values.append(element.toInt());
+    }
+    return values;
+}
+
+QJsonObject MatchAssignment::toJson() const
+{
+    QJsonObject object;
+    object["type"] = "assign";
+    object["id"] = id;
+    object["seed"] = QString::number(seed); // Doesn't fit in a double
+    object["rounds"] = rounds;
+    object["tickInterval"] = tickInterval;
+    object["bots"] = QJsonArray::fromStringList(bots);
+    return object;
+}
+
+MatchAssignment MatchAssignment::fromJson(const QJsonObject &object)
+{
+    MatchAssignment assignment;
+    assignment.id = object["id"].toInt(-1);
+    assignment.seed = object["seed"].toString().toULongLong();
+    assignment.rounds = object["rounds"].toInt();
+    assignment.tickInterval = object["tickInterval"].toInt();
+    for (const QJsonValue &bot : object["bots"].toArray()) {
+        assignment.bots.append(bot.toString());
+    }
+    return assignment;
+}
+
+QJsonObject MatchAssignmentResult::toJson() const
+{
+    QJsonObject object;
+    object["type"] = "result";
+    object["id"] = id;
+    object["bots"] = QJsonArray::fromStringList(bots);
+    object["wins"] = toJsonArray(wins);
+    object["scores"] = toJsonArray(scores);
+    object["energy"] = toJsonArray(energy);
+    if (!error.isEmpty()) {
+        object["error"] = error;
+    }
+    return object;
+}
+
+MatchAssignmentResult MatchAssignmentResult::fromJson(const QJsonObject &object)
+{
+    MatchAssignmentResult result;
+    result.id = object["id"].toInt(-1);
+    for (const QJsonValue &bot : object["bots"].toArray()) {
+        result.bots.append(bot.toString());
+    }
+    result.wins = fromJsonArray(object["wins"]);
+    result.scores = fromJsonArray(object["scores"]);
+    result.energy = fromJsonArray(object["energy"]);
+    result.error = object["error"].toString();
+    return result;
+}
+
+// The seed of a match only depends on the bots in it, so adding a bot to
+// the pool doesn't change the seeds of the matches it isn't in
+static quint64 groupSeed(quint64 seed, const QStringList &bots)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(seed));
+    for (const QString &bot : bots) {
+        hash.addData(" " + bot.toUtf8());
+    }
+
+    const QByteArray result = hash.result();
+    quint64 groupSeed = 0;
+    for (int i=0; i<8; i++) {
+        groupSeed = (groupSeed << 8) | quint8(result[i]);
+    }
+    return groupSeed;
+}
+
+static MatchAssignment createAssignment(int id, const QStringList &bots, int rounds, int tickInterval, quint64 seed)
+{
+    MatchAssignment assignment;
+    assignment.id = id;
+    assignment.seed = seed;
+    assignment.rounds = rounds;
+    assignment.tickInterval = tickInterval;
+    assignment.bots = bots;
+    return assignment;
+}
+
+qint64 roundRobinSize(int botCount, int groupSize)
+{
+    if (groupSize < 1 || groupSize > botCount) {
+        return 0;
+    }
+
+    // botCount choose groupSize, stopping as soon as it gets too big
+    groupSize = qMin(groupSize, botCount - groupSize);
+    qint64 size = 1;
+    for (int i=0; i<groupSize; i++) {
+        size = size * (botCount - i) / (i + 1);
+        if (size > TOURNAMENT_MAX_MATCHES) {
+            return -1;
+        }
+    }
+    return size;
+}
+
+QList<MatchAssignment> roundRobin(const QStringList &bots, int groupSize, int rounds, int tickInterval, quint64 seed)
+{
+    QList<MatchAssignment> assignments;
+    if (roundRobinSize(bots.count(), groupSize) <= 0) {
+        return assignments;
+    }
+
+    // The order in the pool file doesn't matter, each group plays in the same order every time
+    QStringList pool = bots;
+    pool.sort();
+
+    // Walk through all combinations in lexicographic order
+    QVector<int> group(groupSize);
+    for (int i=0; i<groupSize; i++) {
+        group[i] = i;
+    }
+
+    for (;;) {
+        QStringList groupBots;
+        for (int index : group) {
+            groupBots.append(pool[index]);
+        }
+        assignments.append(createAssignment(assignments.count(), groupBots, rounds, tickInterval, groupSeed(seed, groupBots)));
+
+        int i = groupSize - 1;
+        while (i >= 0 && group[i] == bots.count() - groupSize + i) {
+            i--;
+        }
+        if (i < 0) {
+            break;
+        }
+
+        group[i]++;
+        for (int j=i + 1; j<groupSize; j++) {
+            group[j] = group[j - 1] + 1;
+        }
+    }
+
+    return assignments;
+}
+
+QList<MatchAssignment> balancedGroups(const QStringList &bots, int groupSize, int matchesPerBot, int rounds, int tickInterval, quint64 seed)
+{
+    QList<MatchAssignment> assignments;
+    if (groupSize < 1 || groupSize > bots.count() || matchesPerBot < 1) {
+        return assignments;
+    }
+
+    const qint64 groupsPerPass = (bots.count() + groupSize - 1) / groupSize;
+    if (groupsPerPass * matchesPerBot > TOURNAMENT_MAX_MATCHES) {
+        return assignments;
+    }
+
+    Pcg32 random(seed);
+    QVector<int> order(bots.count());
+    for (int i=0; i<order.count(); i++) {
+        order[i] = i;
+    }
+
+    // Every pass shuffles the pool and splits it up into groups
+    for (int pass=0; pass<matchesPerBot; pass++) {
+        for (int i=order.count() - 1; i>0; i--) {
+            std::swap(order[i], order[random.bounded(i + 1)]);
+        }
+
+        for (int start=0; start<order.count(); start+=groupSize) {
+            QStringList groupBots;
+            for (int i=start; i<start + groupSize; i++) {
+                // The last group is filled up with the first ones of the pass, they aren't in it already
+                groupBots.append(bots[order[i < order.count() ? i : i - order.count()]]);
+            }
+            // The same bots can end up together in more than one pass, they still get different seeds
+            assignments.append(createAssignment(assignments.count(), groupBots, rounds, tickInterval, groupSeed(seed + pass, groupBots)));
+        }
+    }
+
+    return assignments;
+}
+
+bool isBuiltinMatch(const QStringList &bots)
+{
+    for (const QString &bot : bots) {
+        std::unique_ptr<Bot> test(createBot(bot.toStdString(), 0));
+        if (!test) {
+            return false;
+        }
+    }
+
+    return true;
+}
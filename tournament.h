@@ -0,0 +1,71 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// The coordinator and the workers talk over TCP, one compact JSON object per line:
+//
+//  worker -> coordinator:
+//   {"type": "hello", "slots": 2}         Ready to play two matches at once
+//   {"type": "heartbeat"}                 Still alive, sent every few seconds
+//   {"type": "result", ...}               See MatchAssignmentResult
+//  coordinator -> worker:
+//   {"type": "assign", ...}               See MatchAssignment
+//   {"type": "done"}                      Nothing more to play, quit
+
+#define TOURNAMENT_HEARTBEAT_INTERVAL 5000
+#define TOURNAMENT_WORKER_TIMEOUT 20000
+#define TOURNAMENT_MAX_ATTEMPTS 3
+
+// More matches than this in one tournament take too much memory to keep track of
+#define TOURNAMENT_MAX_MATCHES 100000
+
+// One match to play. A bot is either the name of a built in bot, or a
+// command line that starts a bot connecting to the port in {port}.
+struct MatchAssignment
+{
+    int id;
+    quint64 seed;
+    int rounds;
+    int tickInterval;
+    QStringList bots;
+
+    QJsonObject toJson() const;
+    static MatchAssignment fromJson(const QJsonObject &object);
+};
+
+struct MatchAssignmentResult
+{
+    int id;
+    QStringList bots;
+    QVector<int> wins;
+    QVector<int> scores;
+    QVector<int> energy;
+    QString error; // Empty if the match was played
+
+    QJsonObject toJson() const;
+    static MatchAssignmentResult fromJson(const QJsonObject &object);
+};
+Q_DECLARE_METATYPE(MatchAssignmentResult)
+
+// How many groups of groupSize there are in a pool of botCount bots, or -1 if more than TOURNAMENT_MAX_MATCHES
+qint64 roundRobinSize(int botCount, int groupSize);
+
+// Every group of groupSize bots from the pool plays one match. The seed of
+// each comes from seed and the bots in it, not from where they are in the pool.
+// Empty if that is more than TOURNAMENT_MAX_MATCHES, check with roundRobinSize first.
+QList<MatchAssignment> roundRobin(const QStringList &bots, int groupSize, int rounds, int tickInterval, quint64 seed);
+
+// Random groups where every bot plays matchesPerBot matches, or one more to fill up the last group.
+// For pools too big to play every group.
+QList<MatchAssignment> balancedGroups(const QStringList &bots, int groupSize, int matchesPerBot, int rounds, int tickInterval, quint64 seed);
+
+// True if all the bots are built in, and can be played without starting any processes
+bool isBuiltinMatch(const QStringList &bots);
+
+#endif // TOURNAMENT_H
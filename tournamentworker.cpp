@@ -0,0 +1,145 @@
+#include "tournamentworker.h"
+
+#include "workermatch.h"
+
+#include <QDebug>
+#include <QJsonDocument>
+
+TournamentWorker::TournamentWorker(const QString &host, quint16 port, int slots, quint16 gamePort, QObject *parent) : QObject(parent),
+    m_host(host),
+    m_port(port),
+    m_slots(slots),
+    m_gamePort(gamePort),
+    m_done(false),
+    m_playing(slots, -1)
+{
+    qRegisterMetaType<MatchAssignmentResult>();
+
+    m_heartbeatTimer.setInterval(TOURNAMENT_HEARTBEAT_INTERVAL);
+    m_reconnectTimer.setInterval(2000);
+    m_reconnectTimer.setSingleShot(true);
+
+    connect(&m_heartbeatTimer, &QTimer::timeout, this, &TournamentWorker::sendHeartbeat);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &TournamentWorker::connectToCoordinator);
+    connect(&m_socket, &QTcpSocket::connected, this, &TournamentWorker::onConnected);
+    connect(&m_socket, &QTcpSocket::disconnected, this, &TournamentWorker::onDisconnected);
+    connect(&m_socket, &QTcpSocket::readyRead, this, &TournamentWorker::onReadyRead);
+    connect(&m_socket, static_cast<void (QTcpSocket::*)(QAbstractSocket::SocketError)>(&QTcpSocket::error), this, [this]() {
+        if (m_socket.state() != QAbstractSocket::ConnectedState && !m_done) {
+            m_reconnectTimer.start();
+        }
+    });
+}
+
+void TournamentWorker::start()
+{
+    connectToCoordinator();
+}
+
+void TournamentWorker::connectToCoordinator()
+{
+    m_socket.abort();
+    m_socket.connectToHost(m_host, m_port);
+}
+
+void TournamentWorker::onConnected()
+{
+    qDebug() << "TournamentWorker: connected to" << m_host << m_port;
+
+    QJsonObject hello;
+    hello["type"] = "hello";
+    hello["slots"] = m_slots;
+    send(hello);
+
+    while (!m_unsent.isEmpty()) {
+        send(m_unsent.takeFirst().toJson());
+    }
+
+    m_heartbeatTimer.start();
+}
+
+void TournamentWorker::onDisconnected()
+{
+    m_heartbeatTimer.stop();
+
+    if (m_done) {
+        return;
+    }
+
+    // The coordinator gives our matches to someone else, but we might as well finish them
+    qWarning() << "TournamentWorker: lost the coordinator, reconnecting";
+    m_reconnectTimer.start();
+}
+
+void TournamentWorker::onReadyRead()
+{
+    while (m_socket.canReadLine()) {
+        const QJsonObject message = QJsonDocument::fromJson(m_socket.readLine()).object();
+        const QString type = message["type"].toString();
+
+        if (type == "assign") {
+            play(MatchAssignment::fromJson(message));
+        } else if (type == "done") {
+            qDebug() << "TournamentWorker: tournament is done";
+            m_done = true;
+            m_socket.disconnectFromHost();
+            emit finished();
+            return;
+        }
+    }
+}
+
+void TournamentWorker::sendHeartbeat()
+{
+    QJsonObject heartbeat;
+    heartbeat["type"] = "heartbeat";
+    send(heartbeat);
+}
+
+void TournamentWorker::play(const MatchAssignment &assignment)
+{
+    const int slot = m_playing.indexOf(-1);
+    if (slot < 0) {
+        m_queued.enqueue(assignment);
+        return;
+    }
+    m_playing[slot] = assignment.id;
+
+    qDebug() << "TournamentWorker: playing match" << assignment.id << assignment.bots;
+
+    if (isBuiltinMatch(assignment.bots)) {
+        BuiltinMatch *match = new BuiltinMatch(assignment, this);
+        connect(match, &BuiltinMatch::matchFinished, this, &TournamentWorker::onMatchFinished);
+        connect(match, &QThread::finished, match, &QObject::deleteLater);
+        match->start();
+    } else {
+        ExternalMatch *match = new ExternalMatch(assignment, m_gamePort + slot, this);
+        connect(match, &ExternalMatch::matchFinished, this, &TournamentWorker::onMatchFinished);
+        connect(match, &ExternalMatch::matchFinished, match, &QObject::deleteLater);
+        match->start();
+    }
+}
+
+void TournamentWorker::onMatchFinished(const MatchAssignmentResult &result)
+{
+    const int slot = m_playing.indexOf(result.id);
+    if (slot >= 0) {
+        m_playing[slot] = -1;
+    }
+
+    if (!m_queued.isEmpty()) {
+        play(m_queued.dequeue());
+    }
+
+    if (m_socket.state() != QAbstractSocket::ConnectedState) {
+        m_unsent.append(result);
+        return;
+    }
+
+    send(result.toJson());
+}
+
+void TournamentWorker::send(const QJsonObject &object)
+{
+    m_socket.write(QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n');
+}
@@ -0,0 +1,60 @@
+#ifndef TOURNAMENTWORKER_H
+#define TOURNAMENTWORKER_H
+
+#include "tournament.h"
+
+#include <QObject>
+#include <QList>
+#include <QQueue>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QVector>
+
+// Connects to a Coordinator, plays the matches it gets and reports back.
+// Keeps trying to reconnect if the coordinator goes away.
+class TournamentWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Bot programs in match number n get port gamePort + n
+    TournamentWorker(const QString &host, quint16 port, int slots, quint16 gamePort, QObject *parent = 0);
+
+    void start();
+
+signals:
+    void finished();
+
+private slots:
+    void connectToCoordinator();
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+    void sendHeartbeat();
+    void onMatchFinished(const MatchAssignmentResult &result);
+
+private:
+    void play(const MatchAssignment &assignment);
+    void send(const QJsonObject &object);
+
+    QString m_host;
+    quint16 m_port;
+    int m_slots;
+    quint16 m_gamePort;
+
+    QTcpSocket m_socket;
+    QTimer m_heartbeatTimer;
+    QTimer m_reconnectTimer;
+    bool m_done;
+
+    // Which match each slot is playing, -1 if free
+    QVector<int> m_playing;
+
+    // After reconnecting we can get new matches before the old ones are done
+    QQueue<MatchAssignment> m_queued;
+
+    // Results that finished while we weren't connected
+    QList<MatchAssignmentResult> m_unsent;
+};
+
+#endif // TOURNAMENTWORKER_H
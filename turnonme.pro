@@ -14,7 +14,36 @@ SOURCES += main.cpp \
     gamemanager.cpp \
     networkclient.cpp \
     missile.cpp \
-    settings.cpp
+    settings.cpp \
+    asyncfilewriter.cpp \
+    matchrecorder.cpp \
+    replay.cpp \
+    replayplayer.cpp \
+    world.cpp \
+    bot.cpp \
+    match.cpp \
+    matchrunner.cpp \
+    arena.cpp \
+    lobby.cpp \
+    tournament.cpp \
+    coordinator.cpp \
+    tournamentworker.cpp \
+    workermatch.cpp \
+    rating.cpp \
+    scheduler.cpp \
+    resultcache.cpp \
+    roundstatistics.cpp \
+    logger.cpp \
+    missilerenderer.cpp \
+    interpolator.cpp \
+    playerrenderer.cpp \
+    particlebudget.cpp \
+    performancemonitor.cpp \
+    videoexporter.cpp \
+    idlemonitor.cpp \
+    scoreboard.cpp \
+    playersprites.cpp \
+    spatialgrid.cpp
 
 HEADERS += \
     player.h \
@@ -22,7 +51,40 @@ HEADERS += \
     networkclient.h \
     parameters.h \
     missile.h \
-    settings.h
+    settings.h \
+    asyncfilewriter.h \
+    matchrecorder.h \
+    recording.h \
+    replay.h \
+    replayplayer.h \
+    pcg32.h \
+    statedigest.h \
+    world.h \
+    bot.h \
+    match.h \
+    matchrunner.h \
+    arena.h \
+    lobby.h \
+    tournament.h \
+    coordinator.h \
+    tournamentworker.h \
+    workermatch.h \
+    rating.h \
+    scheduler.h \
+    resultcache.h \
+    roundstatistics.h \
+    logger.h \
+    missilerenderer.h \
+    interpolator.h \
+    playerrenderer.h \
+    atlasnode.h \
+    particlebudget.h \
+    performancemonitor.h \
+    videoexporter.h \
+    idlemonitor.h \
+    scoreboard.h \
+    playersprites.h \
+    spatialgrid.h
 
 RESOURCES += \
     resources.qrc
@@ -31,10 +93,10 @@ OTHER_FILES += \
     qml/Button.qml \
     qml/EndScreen.qml \
     qml/main.qml \
-    qml/PlayerSprite.qml \
     qml/StartScreen.qml \
     qml/Checkbox.qml \
-    qml/MissileSprite.qml \
+    qml/ReplayControls.qml \
+    qml/PerformanceOverlay.qml \
 
 DISTFILES += \
     sprites/missile-empty.png \
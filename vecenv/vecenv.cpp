@@ -0,0 +1,193 @@
+#define _USE_MATH_DEFINES // because windows sucks assss
+#include "vecenv.h"
+
+#include "../parameters.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define SHIP_FEATURES 8
+#define MISSILE_FEATURES 8
+
+// Rewards, per ship per tick
+#define REWARD_HIT 1.0f
+#define REWARD_DEATH -10.0f
+#define REWARD_WIN 10.0f
+
+VecEnv::VecEnv(int worldCount, int playersPerWorld, uint64_t seed, int observedMissiles, int maxTicks) :
+    m_playersPerWorld(playersPerWorld),
+    m_observedMissiles(observedMissiles),
+    m_maxTicks(maxTicks),
+    m_commands(playersPerWorld, CommandNone),
+    m_wasAlive(playersPerWorld, false)
+{
+    m_worlds.reserve(worldCount);
+    for (int i=0; i<worldCount; i++) {
+        m_worlds.push_back(World(seed + i));
+        m_worlds.back().setShipCount(playersPerWorld);
+    }
+}
+
+int VecEnv::observationSize() const
+{
+    return SHIP_FEATURES * m_playersPerWorld + MISSILE_FEATURES * m_observedMissiles;
+}
+
+void VecEnv::reset(float *observations)
+{
+    const int stride = m_playersPerWorld * observationSize();
+    for (size_t w=0; w<m_worlds.size(); w++) {
+        m_worlds[w].startRound();
+        observe(w, observations + w * stride);
+    }
+}
+
+void VecEnv::step(const int32_t *actions, float *observations, float *rewards, uint8_t *dones)
+{
+    const int stride = m_playersPerWorld * observationSize();
+
+    for (size_t w=0; w<m_worlds.size(); w++) {
+        World &world = m_worlds[w];
+        const int32_t *worldActions = actions + w * m_playersPerWorld;
+        float *worldRewards = rewards + w * m_playersPerWorld;
+
+        for (int i=0; i<m_playersPerWorld; i++) {
+            const int32_t action = worldActions[i];
+            m_commands[i] = (action > CommandNone && action <= CommandMine) ? uint8_t(action) : uint8_t(CommandNone);
+            worldRewards[i] = 0;
+        }
+
+        for (int i=0; i<m_playersPerWorld; i++) {
+            m_wasAlive[i] = world.ships()[i].alive;
+        }
+
+        bool done = world.step(m_commands.data());
+
+        for (const Hit &hit : world.hits()) {
+            worldRewards[hit.owner] += REWARD_HIT;
+            worldRewards[hit.ship] -= REWARD_HIT;
+        }
+
+        for (int i=0; i<m_playersPerWorld; i++) {
+            if (m_wasAlive[i] && !world.ships()[i].alive) {
+                worldRewards[i] += REWARD_DEATH;
+            }
+        }
+
+        if (done) {
+            for (int i=0; i<m_playersPerWorld; i++) {
+                if (world.ships()[i].alive) {
+                    worldRewards[i] += REWARD_WIN;
+                }
+            }
+        }
+
+        if (world.tick() >= m_maxTicks) {
+            done = true;
+        }
+
+        dones[w] = done;
+        if (done) {
+            world.startRound();
+        }
+
+        observe(w, observations + w * stride);
+    }
+}
+
+void VecEnv::observe(int worldIndex, float *observations)
+{
+    const World &world = m_worlds[worldIndex];
+    const std::vector<ShipState> &ships = world.ships();
+    const std::vector<MissileState> &missiles = world.missiles();
+
+    std::fill(observations, observations + m_playersPerWorld * observationSize(), 0.0f);
+
+    for (int i=0; i<m_playersPerWorld; i++) {
+        const ShipState &self = ships[i];
+        float *out = observations + i * observationSize();
+
+        const double angle = self.rotation * M_PI * 2.0 / 360.0;
+        *out++ = self.x;
+        *out++ = self.y;
+        *out++ = self.velocityX;
+        *out++ = self.velocityY;
+        *out++ = cos(angle);
+        *out++ = sin(angle);
+        *out++ = self.energy / float(START_ENERGY);
+        *out++ = self.alive;
+
+        for (int j=0; j<m_playersPerWorld; j++) {
+            if (j == i) {
+                continue;
+            }
+
+            const ShipState &other = ships[j];
+            const double otherAngle = other.rotation * M_PI * 2.0 / 360.0;
+            *out++ = other.x - self.x;
+            *out++ = other.y - self.y;
+            *out++ = other.velocityX;
+            *out++ = other.velocityY;
+            *out++ = cos(otherAngle);
+            *out++ = sin(otherAngle);
+            *out++ = other.energy / float(START_ENERGY);
+            *out++ = other.alive;
+        }
+
+        if (m_observedMissiles <= 0) {
+            continue;
+        }
+
+        m_closest.clear();
+        for (size_t m=0; m<missiles.size(); m++) {
+            const double dx = missiles[m].x - self.x;
+            const double dy = missiles[m].y - self.y;
+            m_closest.push_back(std::make_pair(dx * dx + dy * dy, int(m)));
+        }
+
+        const size_t count = std::min<size_t>(m_observedMissiles, m_closest.size());
+        std::partial_sort(m_closest.begin(), m_closest.begin() + count, m_closest.end());
+
+        for (size_t m=0; m<count; m++) {
+            const MissileState &missile = missiles[m_closest[m].second];
+            *out++ = missile.x - self.x;
+            *out++ = missile.y - self.y;
+            *out++ = missile.velocityX;
+            *out++ = missile.velocityY;
+            *out++ = missile.energy / 1000.0f;
+            *out++ = missile.owner == i;
+            *out++ = missile.type == MissileSeeking;
+            *out++ = missile.type == MissileMine;
+        }
+        // The rest stays zeroed
+    }
+}
+
+VecEnv *vecenv_create(int worldCount, int playersPerWorld, uint64_t seed, int observedMissiles, int maxTicks)
+{
+    if (worldCount <= 0 || playersPerWorld <= 0 || observedMissiles < 0 || maxTicks <= 0) {
+        return nullptr;
+    }
+
+    return new VecEnv(worldCount, playersPerWorld, seed, observedMissiles, maxTicks);
+}
+
+void vecenv_destroy(VecEnv *env)
+{
+    delete env;
+}
+
+int vecenv_observation_size(const VecEnv *env)
+{
+    return env->observationSize();
+}
+
+void vecenv_reset(VecEnv *env, float *observations)
+{
+    env->reset(observations);
+}
+
+void vecenv_step(VecEnv *env, const int32_t *actions, float *observations, float *rewards, uint8_t *dones)
+{
+    env->step(actions, observations, rewards, dones);
+}
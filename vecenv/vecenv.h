@@ -0,0 +1,59 @@
+#ifndef VECENV_H
+#define VECENV_H
+
+#include "../world.h"
+
+#include <cstdint>
+#include <vector>
+
+// Steps many independent worlds in lockstep, for training bots without going
+// through the server. Everything is flat arrays, one row per ship:
+//
+//  actions:      worldCount * playersPerWorld int32, a Command each
+//  observations: worldCount * playersPerWorld * observationSize() floats
+//  rewards:      worldCount * playersPerWorld floats
+//  dones:        worldCount bytes, set when a round ended in that world
+//
+// A world that is done starts a new round straight away, so the observations
+// returned for it are from the first tick of the next round.
+class VecEnv
+{
+public:
+    VecEnv(int worldCount, int playersPerWorld, uint64_t seed, int observedMissiles = 8, int maxTicks = 5000);
+
+    int worldCount() const { return m_worlds.size(); }
+    int playersPerWorld() const { return m_playersPerWorld; }
+
+    // Floats per ship:
+    //  8 for itself (x, y, velocityX, velocityY, cos/sin of rotation, energy, alive),
+    //  8 for each other ship, relative to itself,
+    //  8 for each of the closest missiles (dx, dy, velocityX, velocityY, energy, own, seeking, mine)
+    int observationSize() const;
+
+    void reset(float *observations);
+    void step(const int32_t *actions, float *observations, float *rewards, uint8_t *dones);
+
+private:
+    void observe(int world, float *observations);
+
+    std::vector<World> m_worlds;
+    int m_playersPerWorld;
+    int m_observedMissiles;
+    int m_maxTicks;
+
+    // Scratch space, so stepping doesn't allocate
+    std::vector<uint8_t> m_commands;
+    std::vector<uint8_t> m_wasAlive;
+    std::vector<std::pair<double, int>> m_closest;
+};
+
+// For loading with ctypes or similar, so no C++ is needed on the other side
+extern "C" {
+VecEnv *vecenv_create(int worldCount, int playersPerWorld, uint64_t seed, int observedMissiles, int maxTicks);
+void vecenv_destroy(VecEnv *env);
+int vecenv_observation_size(const VecEnv *env);
+void vecenv_reset(VecEnv *env, float *observations);
+void vecenv_step(VecEnv *env, const int32_t *actions, float *observations, float *rewards, uint8_t *dones);
+}
+
+#endif // VECENV_H
@@ -0,0 +1,23 @@
+# The game rules without Qt, as a library for training bots.
+# Build with qmake && make, and load the vecenv_* functions with ctypes or similar.
+
+TEMPLATE = lib
+TARGET = vecenv
+
+CONFIG += c++11 release
+CONFIG -= qt
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    vecenv.cpp \
+    ../world.cpp \
+    ../spatialgrid.cpp
+
+HEADERS += \
+    vecenv.h \
+    ../world.h \
+    ../spatialgrid.h \
+    ../pcg32.h \
+    ../statedigest.h \
+    ../parameters.h
@@ -0,0 +1,241 @@
+#include "videoexporter.h"
+
+#include "gamemanager.h"
+#include "idlemonitor.h"
+#include "particlebudget.h"
+#include "performancemonitor.h"
+#include "playersprites.h"
+#include "replayplayer.h"
+
+#include <QAbstractAnimation>
+#include <QAnimationDriver>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickRenderControl>
+#include <QQuickWindow>
+#include <QScopedPointer>
+
+namespace {
+
+// Lets us decide what time it is for the animations, instead of the wall clock
+class ManualAnimationDriver : public QAnimationDriver
+{
+public:
+    ManualAnimationDriver() : m_time(0) {}
+
+    void advanceTo(qint64 time)
+    {
+        m_time = time;
+        advance();
+    }
+
+    qint64 elapsed() const override { return m_time; }
+
+private:
+    qint64 m_time;
+};
+
+// Set by prepare()
+bool s_openGL = false;
+
+QSurfaceFormat surfaceFormat()
+{
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+    return format;
+}
+
+}
+
+VideoExporter::VideoExporter() :
+    m_size(1280, 720),
+    m_frameRate(60),
+    m_raw(false)
+{
+}
+
+void VideoExporter::prepare()
+{
+    // The software backend can't draw particles or shader effects, so only use it when we have to
+    QOpenGLContext context;
+    context.setFormat(surfaceFormat());
+    s_openGL = context.create();
+
+    if (!s_openGL) {
+        qDebug() << "VideoExporter: no OpenGL, drawing without particles and blur";
+        QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+    }
+}
+
+bool VideoExporter::exportReplay(const QString &replayFileName, const QString &outputDirectory)
+{
+    if (m_frameRate <= 0 || m_size.isEmpty()) {
+        m_errorString = "Invalid frame rate or size";
+        return false;
+    }
+
+    if (!QDir().mkpath(outputDirectory)) {
+        m_errorString = "Unable to create " + outputDirectory;
+        return false;
+    }
+
+    QFile rawFile(QDir(outputDirectory).filePath("frames.rgb"));
+    if (m_raw && !rawFile.open(QIODevice::WriteOnly)) {
+        m_errorString = rawFile.errorString();
+        return false;
+    }
+
+    ManualAnimationDriver animationDriver;
+    animationDriver.install();
+
+    QQuickRenderControl renderControl;
+    QQuickWindow window(&renderControl);
+    window.setGeometry(0, 0, m_size.width(), m_size.height());
+    window.contentItem()->setSize(m_size);
+
+    // With OpenGL everything is drawn into a framebuffer we read the frames back from
+    QScopedPointer<QOpenGLContext> context;
+    QOffscreenSurface surface;
+    QScopedPointer<QOpenGLFramebufferObject> framebuffer;
+    if (s_openGL) {
+        context.reset(new QOpenGLContext);
+        context->setFormat(surfaceFormat());
+        surface.setFormat(surfaceFormat());
+        surface.create();
+        if (!context->create() || !context->makeCurrent(&surface)) {
+            m_errorString = "Unable to create an OpenGL context";
+            animationDriver.uninstall();
+            return false;
+        }
+
+        framebuffer.reset(new QOpenGLFramebufferObject(m_size, QOpenGLFramebufferObject::CombinedDepthStencil));
+        window.setRenderTarget(framebuffer.data());
+    }
+
+    QQmlEngine engine;
+    engine.addImageProvider("players", new PlayerSpriteProvider);
+
+    // Every frame may take as long as it needs, so there's no reason to cut down on particles.
+    // The software backend doesn't draw them at all.
+    ParticleBudget *particleBudget = new ParticleBudget(&window);
+    particleBudget->setAdaptive(false);
+    engine.rootContext()->setContextProperty("ParticleBudget", particleBudget);
+
+    GameManager manager(&window, engine.rootContext());
+    manager.setFrameTime(0);
+
+    PerformanceMonitor *performanceMonitor = new PerformanceMonitor(&manager, &window, particleBudget);
+    engine.rootContext()->setContextProperty("PerformanceMonitor", performanceMonitor);
+
+    // Never goes idle while a replay is loaded, but the QML wants it
+    IdleMonitor *idleMonitor = new IdleMonitor(&manager, &window);
+    engine.rootContext()->setContextProperty("IdleMonitor", idleMonitor);
+
+    if (!manager.loadReplay(replayFileName)) {
+        m_errorString = "Unable to open " + replayFileName;
+        animationDriver.uninstall();
+        return false;
+    }
+
+    // We decide which frame to show
+    ReplayPlayer *replay = static_cast<ReplayPlayer*>(manager.replay());
+    replay->pause();
+
+    QQmlComponent component(&engine, QUrl("qrc:/qml/main.qml"));
+    QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem*>(component.create()));
+    if (!root) {
+        m_errorString = component.errorString();
+        animationDriver.uninstall();
+        return false;
+    }
+    root->setParentItem(window.contentItem());
+    root->setSize(m_size);
+
+    renderControl.initialize(context.data());
+
+    int tickInterval = replay->header().tickInterval;
+    if (tickInterval <= 0) {
+        tickInterval = DEFAULT_TICKINTERVAL;
+    }
+    const qint64 duration = qint64(replay->frameCount() - 1) * tickInterval;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int frame = 0;
+    for (;; frame++) {
+        const qint64 time = qint64(frame) * 1000 / m_frameRate;
+        if (time > duration) {
+            break;
+        }
+
+        manager.setFrameTime(time);
+
+        const int replayFrame = int(time / tickInterval);
+        if (replayFrame != replay->frame()) {
+            replay->seek(replayFrame);
+        }
+
+        animationDriver.advanceTo(time);
+        manager.advanceFrame();
+
+        // Get rid of the objects for missiles that are gone, there's no event loop to do it
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCoreApplication::processEvents();
+
+        renderControl.polishItems();
+        renderControl.sync();
+
+        QImage image;
+        if (framebuffer) {
+            renderControl.render();
+            context->functions()->glFlush();
+            image = framebuffer->toImage();
+        } else {
+            image = renderControl.grab();
+        }
+
+        if (m_raw) {
+            const QImage rgb = image.convertToFormat(QImage::Format_RGB888);
+            for (int y=0; y<rgb.height(); y++) {
+                rawFile.write(reinterpret_cast<const char*>(rgb.constScanLine(y)), rgb.width() * 3);
+            }
+        } else {
+            const QString fileName = QDir(outputDirectory).filePath(QString("frame%1.png").arg(frame, 6, 10, QChar('0')));
+            if (!image.save(fileName)) {
+                m_errorString = "Unable to write " + fileName;
+                animationDriver.uninstall();
+                return false;
+            }
+        }
+
+        if (frame % (m_frameRate * 10) == 0) {
+            qDebug() << "VideoExporter: at" << time / 1000 << "of" << duration / 1000 << "seconds";
+        }
+    }
+
+    animationDriver.uninstall();
+
+    // The scene graph has to let go of its OpenGL resources while the context is still current
+    if (context) {
+        root.reset();
+        renderControl.invalidate();
+        framebuffer.reset();
+    }
+
+    qDebug() << "VideoExporter: wrote" << frame << "frames of" << m_size << "in" << timer.elapsed() / 1000.0 << "seconds";
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef VIDEOEXPORTER_H
+#define VIDEOEXPORTER_H
+
+#include <QSize>
+#include <QString>
+
+// Renders a recorded match into image files without any window, as fast as
+// the machine allows. The normal game scene is drawn into an offscreen OpenGL
+// framebuffer, with the animation clock stepped by hand for every frame. When
+// there's no OpenGL it falls back to the Qt Quick software backend, so it works
+// on machines without a GPU or display, but without particles and blur then.
+class VideoExporter
+{
+public:
+    VideoExporter();
+
+    void setSize(const QSize &size) { m_size = size; }
+    void setFrameRate(int frameRate) { m_frameRate = frameRate; }
+
+    // Write all frames as raw 24 bit RGB into one file, frames.rgb, instead of a PNG file for each
+    void setRaw(bool raw) { m_raw = raw; }
+
+    // Picks OpenGL or the software backend, call before the first QQuickWindow is created
+    static void prepare();
+
+    bool exportReplay(const QString &replayFileName, const QString &outputDirectory);
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    QSize m_size;
+    int m_frameRate;
+    bool m_raw;
+    QString m_errorString;
+};
+
+#endif // VIDEOEXPORTER_H
@@ -0,0 +1,232 @@
+#include "workermatch.h"
+
+#include "match.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QProcessEnvironment>
+
+#include <climits>
+
+// How long a bot gets to connect, and a round to finish
+#define BOT_CONNECT_TIMEOUT 30000
+#define ROUND_TIMEOUT 300000
+
+BuiltinMatch::BuiltinMatch(const MatchAssignment &assignment, QObject *parent) : QThread(parent),
+    m_assignment(assignment)
+{
+}
+
+void BuiltinMatch::run()
+{
+    MatchConfig config;
+    config.seed = m_assignment.seed;
+    config.rounds = m_assignment.rounds;
+    config.maxTicks = 10000;
+    for (const QString &bot : m_assignment.bots) {
+        config.bots.push_back(bot.toStdString());
+    }
+
+    Match match(config);
+    match.run(INT_MAX);
+
+    MatchAssignmentResult result;
+    result.id = m_assignment.id;
+    result.bots = m_assignment.bots;
+    if (!match.isValid()) {
+        result.error = "Unknown bot";
+    }
+    for (size_t i=0; i<config.bots.size(); i++) {
+        result.wins.append(match.result().wins[i]);
+        result.scores.append(match.result().scores[i]);
+        result.energy.append(match.result().energy[i]);
+    }
+
+    emit matchFinished(result);
+}
+
+ExternalMatch::ExternalMatch(const MatchAssignment &assignment, quint16 port, QObject *parent) : QObject(parent),
+    m_assignment(assignment),
+    m_port(port),
+    m_game(nullptr),
+    m_connected(0),
+    m_finished(false)
+{
+    m_result.id = assignment.id;
+    m_result.bots = assignment.bots;
+
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, &ExternalMatch::onTimeout);
+}
+
+ExternalMatch::~ExternalMatch()
+{
+    stopProcesses();
+}
+
+void ExternalMatch::start()
+{
+    if (!m_directory.isValid()) {
+        fail("Unable to create a temporary directory");
+        return;
+    }
+
+    QStringList arguments;
+    arguments << "--headless"
+              << "--status"
+              << "--port" << QString::number(m_port)
+              << "--max-players" << QString::number(m_assignment.bots.count())
+              << "--start-at" << QString::number(m_assignment.bots.count())
+              << "--rounds" << QString::number(m_assignment.rounds)
+              << "--seed" << QString::number(m_assignment.seed)
+              << "--results" << m_directory.filePath("results.json")
+              << "--quit-on-finish";
+    if (m_assignment.tickInterval > 0) {
+        arguments << "--tick-interval" << QString::number(m_assignment.tickInterval);
+    }
+
+    // The scores and log end up in the temporary directory, so matches don't trample each other
+    m_game = new QProcess(this);
+    m_game->setWorkingDirectory(m_directory.path());
+    m_game->setProcessChannelMode(QProcess::MergedChannels);
+    connect(m_game, &QProcess::readyReadStandardOutput, this, &ExternalMatch::onGameOutput);
+    connect(m_game, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &ExternalMatch::onGameFinished);
+
+    m_game->start(QCoreApplication::applicationFilePath(), arguments);
+    m_timeout.start(BOT_CONNECT_TIMEOUT);
+}
+
+void ExternalMatch::onGameOutput()
+{
+    // Everything but the STATUS lines from --status is the log
+    while (m_game->canReadLine()) {
+        const QByteArray line = m_game->readLine().trimmed();
+
+        if (line.startsWith("STATUS LISTENING ")) {
+            startNextBot();
+            continue;
+        }
+
+        if (line.startsWith("STATUS CONNECTED ")) {
+            m_connected++;
+            startNextBot();
+        }
+    }
+}
+
+void ExternalMatch::onGameFinished()
+{
+    if (m_finished) {
+        return;
+    }
+
+    // Read the rest, in case there's something interesting there
+    onGameOutput();
+
+    QFile resultsFile(m_directory.filePath("results.json"));
+    if (!resultsFile.open(QIODevice::ReadOnly)) {
+        fail("The game quit without any results, exit code " + QString::number(m_game->exitCode()));
+        return;
+    }
+
+    const QJsonObject results = QJsonDocument::fromJson(resultsFile.readAll()).object();
+    const QJsonArray players = results["players"].toArray();
+    if (players.count() != m_assignment.bots.count()) {
+        fail("Only " + QString::number(players.count()) + " players were left at the end");
+        return;
+    }
+
+    m_result.wins.fill(0, players.count());
+    m_result.scores.fill(0, players.count());
+    m_result.energy.fill(0, players.count());
+    for (const QJsonValue &value : players) {
+        const QJsonObject player = value.toObject();
+        const int id = player["id"].toInt(-1);
+        if (id < 0 || id >= players.count()) {
+            fail("Invalid player id in the results");
+            return;
+        }
+
+        m_result.wins[id] = player["wins"].toInt();
+        m_result.scores[id] = player["score"].toInt();
+        m_result.energy[id] = player["energy"].toInt();
+    }
+
+    finish();
+}
+
+void ExternalMatch::onTimeout()
+{
+    if (m_connected < m_assignment.bots.count()) {
+        fail("Bot " + QString::number(m_connected) + " didn't connect in time: " + m_assignment.bots.value(m_connected));
+    } else {
+        fail("The match took too long");
+    }
+}
+
+void ExternalMatch::startNextBot()
+{
+    if (m_bots.count() > m_connected) {
+        // Still waiting for the last one to connect
+        return;
+    }
+
+    if (m_bots.count() >= m_assignment.bots.count()) {
+        m_timeout.start(ROUND_TIMEOUT * m_assignment.rounds);
+        return;
+    }
+
+    QString command = m_assignment.bots[m_bots.count()];
+    command.replace("{port}", QString::number(m_port));
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("TURNONME_PORT", QString::number(m_port));
+
+    QProcess *bot = new QProcess(this);
+    bot->setProcessEnvironment(environment);
+    bot->setStandardOutputFile(QProcess::nullDevice());
+    bot->setStandardErrorFile(QProcess::nullDevice());
+    bot->start(command);
+    m_bots.append(bot);
+
+    m_timeout.start(BOT_CONNECT_TIMEOUT);
+}
+
+void ExternalMatch::fail(const QString &error)
+{
+    qWarning() << "ExternalMatch: match" << m_assignment.id << "failed:" << error;
+    m_result.error = error;
+    finish();
+}
+
+void ExternalMatch::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+
+    m_timeout.stop();
+    stopProcesses();
+    emit matchFinished(m_result);
+}
+
+void ExternalMatch::stopProcesses()
+{
+    QList<QProcess*> processes = m_bots;
+    if (m_game) {
+        processes.append(m_game);
+        disconnect(m_game, nullptr, this, nullptr);
+    }
+
+    for (QProcess *process : processes) {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+    }
+}
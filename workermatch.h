@@ -0,0 +1,71 @@
+#ifndef WORKERMATCH_H
+#define WORKERMATCH_H
+
+#include "tournament.h"
+
+#include <QObject>
+#include <QList>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+
+class QProcess;
+
+// A match between built in bots, played on its own thread
+class BuiltinMatch : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit BuiltinMatch(const MatchAssignment &assignment, QObject *parent = 0);
+
+signals:
+    void matchFinished(const MatchAssignmentResult &result);
+
+protected:
+    void run() override;
+
+private:
+    MatchAssignment m_assignment;
+};
+
+// A match between bot programs: starts a headless copy of the game on its
+// own port, and the bots one at a time so they get the ids in the order
+// they are listed, and then waits for the game to quit.
+class ExternalMatch : public QObject
+{
+    Q_OBJECT
+
+public:
+    ExternalMatch(const MatchAssignment &assignment, quint16 port, QObject *parent = 0);
+    ~ExternalMatch();
+
+    void start();
+
+signals:
+    void matchFinished(const MatchAssignmentResult &result);
+
+private slots:
+    void onGameOutput();
+    void onGameFinished();
+    void onTimeout();
+
+private:
+    void startNextBot();
+    void fail(const QString &error);
+    void finish();
+    void stopProcesses();
+
+    MatchAssignment m_assignment;
+    MatchAssignmentResult m_result;
+    quint16 m_port;
+
+    QTemporaryDir m_directory;
+    QProcess *m_game;
+    QList<QProcess*> m_bots;
+    int m_connected;
+    QTimer m_timeout;
+    bool m_finished;
+};
+
+#endif // WORKERMATCH_H
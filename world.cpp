@@ -0,0 +1,584 @@
+#define _USE_MATH_DEFINES // because windows sucks assss
+#include "world.h"
+
+#include "parameters.h"
+#include "statedigest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// More ships than this don't fit on one ring around the sun without touching
+#define PLACE_RING_MAX_SHIPS 16
+#define PLACE_INNER_RADIUS 0.25
+#define PLACE_OUTER_RADIUS 0.9
+
+#define MISSILE_HIT_DISTANCE 0.1
+
+// Roughly one ship per cell, a few ships are quicker to just look through
+#define SHIP_GRID_MAX_CELLS 32
+
+namespace {
+
+void setShipRotation(ShipState &ship, int rotation)
+{
+    if (rotation < 0) {
+        rotation += 360;
+    }
+    if (rotation > 360) {
+        rotation -= 360;
+    }
+
+    ship.rotation = rotation;
+}
+
+void decreaseEnergy(ShipState &ship, int amount)
+{
+    if (ship.energy <= 0) {
+        return;
+    }
+
+    ship.energy -= amount;
+    if (ship.energy < 0) ship.energy = 0;
+
+    if (ship.energy == 0 && ship.alive) {
+        ship.alive = false;
+    }
+}
+
+void increaseEnergy(ShipState &ship, int amount)
+{
+    if (ship.energy <= 0) {
+        return;
+    }
+
+    ship.energy += amount;
+}
+
+void rotateShip(ShipState &ship, int amount)
+{
+    if (ship.energy <= 0) {
+        return;
+    }
+
+    decreaseEnergy(ship, ROTATE_COST);
+    setShipRotation(ship, ship.rotation + amount);
+}
+
+void accelerateShip(ShipState &ship)
+{
+    if (ship.energy <= 0) {
+        return;
+    }
+
+    double angle = ship.rotation * M_PI * 2.0 / 360.0;
+    ship.velocityX += cos(angle) * ACCELERATION_FORCE;
+    ship.velocityY += sin(angle) * ACCELERATION_FORCE;
+    decreaseEnergy(ship, ACCELERATION_COST);
+}
+
+void moveShip(ShipState &ship)
+{
+    if (ship.energy <= 0) {
+        return;
+    }
+
+    double x = ship.x;
+    double y = ship.y;
+
+    const double angle = atan2(y, x);
+    const double distance = hypot(x, y);
+
+    if (distance < 0.1) {
+        ship.alive = false;
+        return;
+    }
+
+    const double force = distance / ship.energy;
+    ship.velocityX -= cos(angle) * force;
+    ship.velocityY -= sin(angle) * force;
+
+    if (ship.velocityX > 0.05) ship.velocityX = 0.05;
+    if (ship.velocityY > 0.05) ship.velocityY = 0.05;
+    if (ship.velocityX < -0.05) ship.velocityX = -0.05;
+    if (ship.velocityY < -0.05) ship.velocityY = -0.05;
+
+    x += ship.velocityX;
+    y += ship.velocityY;
+
+    if (x > 1.0) { x = -1.0; }
+    if (y > 1.0) { y = -1.0; }
+    if (x < -1.0) { x = 1.0; }
+    if (y < -1.0) { y = 1.0; }
+
+    ship.x = x;
+    ship.y = y;
+}
+
+// From one position to another the shortest way, which may be across an edge
+double wrappedDelta(double from, double to)
+{
+    double delta = to - from;
+    if (delta > 1.0) {
+        delta -= 2.0;
+    } else if (delta < -1.0) {
+        delta += 2.0;
+    }
+    return delta;
+}
+
+void setMissileRotation(MissileState &missile, double rotation)
+{
+    if (rotation < 0) {
+        rotation += M_PI * 2.0;
+    }
+
+    if (rotation > M_PI * 2.0) {
+        rotation -= M_PI * 2.0;
+    }
+
+    missile.rotation = rotation;
+}
+
+MissileState createMissile(MissileType type, const ShipState &ship, int owner, uint32_t id)
+{
+    MissileState missile;
+    missile.id = id;
+    missile.type = type;
+    missile.owner = owner;
+    missile.target = -1;
+    missile.x = ship.x;
+    missile.y = ship.y;
+    missile.alive = true;
+
+    if (type == MissileMine) {
+        setMissileRotation(missile, atan2(ship.y, ship.x));
+
+        missile.velocityX = cos(missile.rotation) * 0.005;
+        missile.velocityY = sin(missile.rotation) * 0.005;
+        missile.energy = 5000;
+        return missile;
+    }
+
+    setMissileRotation(missile, (ship.rotation * M_PI * 2) / 360.0);
+
+    if (type == MissileNormal) {
+        missile.velocityX = cos(missile.rotation) * 0.05;
+        missile.velocityY = sin(missile.rotation) * 0.05;
+    } else {
+        missile.velocityX = cos(missile.rotation) * 0.03;
+        missile.velocityY = sin(missile.rotation) * 0.03;
+    }
+
+    missile.energy = 1000;
+    return missile;
+}
+
+void moveMissile(MissileState &missile)
+{
+    double x = missile.x;
+    double y = missile.y;
+    const double distance = hypot(x, y);
+
+    if (distance < 0.1) {
+        missile.alive = false;
+        return;
+    }
+
+    double velocityMagnitude = hypot(missile.velocityX, missile.velocityY);
+    if (velocityMagnitude > MISSILE_MAX_SPEED) {
+        double velocityAngle = atan2(missile.velocityY, missile.velocityX);
+        missile.velocityX = cos(velocityAngle) * MISSILE_MAX_SPEED;
+        missile.velocityY = sin(velocityAngle) * MISSILE_MAX_SPEED;
+    }
+
+    const double force = distance / 1000;
+    const double angle = atan2(y, x);
+    missile.velocityX -= cos(angle) * force;
+    missile.velocityY -= sin(angle) * force;
+
+    x += missile.velocityX;
+    y += missile.velocityY;
+
+    if (x > 1.0) { x = -1.0; }
+    if (y > 1.0) { y = -1.0; }
+    if (x < -1.0) { x = 1.0; }
+    if (y < -1.0) { y = 1.0; }
+
+    missile.x = x;
+    missile.y = y;
+
+    // Always point in the right direction
+    if (missile.type == MissileNormal) {
+        setMissileRotation(missile, atan2(missile.velocityY, missile.velocityX));
+    }
+
+    // Just fall into the sun
+    if (missile.energy < 10) {
+        missile.velocityX /= 1.01;
+        missile.velocityY /= 1.01;
+        return;
+    }
+
+    if (missile.type == MissileMine) {
+        missile.velocityX += cos(missile.rotation) * 0.0005;
+        missile.velocityY += sin(missile.rotation) * 0.0005;
+        missile.energy -= 1;
+        return;
+    }
+
+    missile.energy -= 50;
+
+    if (missile.type == MissileNormal) {
+        missile.velocityX += cos(missile.rotation) * (missile.energy / 1000000.0);
+        missile.velocityY += sin(missile.rotation) * (missile.energy / 1000000.0);
+    } else if (missile.type == MissileSeeking) {
+        missile.velocityX += cos(missile.rotation) * (missile.energy / 100000.0);
+        missile.velocityY += sin(missile.rotation) * (missile.energy / 100000.0);
+    }
+}
+
+const char *s_commandNames[] = {
+    "",
+    "ACCELERATE",
+    "LEFT",
+    "RIGHT",
+    "MISSILE",
+    "SEEKING",
+    "MINE"
+};
+
+} // namespace
+
+Command commandFromName(const char *name)
+{
+    for (int command = CommandAccelerate; command <= CommandMine; command++) {
+        if (strcmp(name, s_commandNames[command]) == 0) {
+            return Command(command);
+        }
+    }
+
+    return CommandNone;
+}
+
+const char *commandName(int command)
+{
+    if (command < CommandNone || command > CommandMine) {
+        return s_commandNames[CommandNone];
+    }
+
+    return s_commandNames[command];
+}
+
+uint64_t rulesetHash()
+{
+    StateDigest digest;
+    digest.addReal(MISSILE_MAX_SPEED);
+    digest.addReal(ACCELERATION_FORCE);
+    digest.addInteger(ACCELERATION_COST);
+    digest.addInteger(MISSILE_COST);
+    digest.addInteger(SEEKING_MISSILE_COST);
+    digest.addInteger(MINE_COST);
+    digest.addInteger(MISSILE_DAMAGE);
+    digest.addInteger(SEEKING_RETARGET_INTERVAL);
+    digest.addInteger(ROTATE_COST);
+    digest.addInteger(ROTATE_AMOUNT);
+    digest.addInteger(START_ENERGY);
+    digest.addInteger(MAX_PLAYERS);
+    return digest.value();
+}
+
+World::World(uint64_t seed) :
+    m_missiles(std::make_shared<std::vector<MissileState>>()),
+    m_shipGrid(1),
+    m_random(seed),
+    m_nextMissileId(0),
+    m_tick(0)
+{
+}
+
+void World::setSeed(uint64_t seed)
+{
+    m_random.setSeed(seed);
+    m_nextMissileId = 0;
+}
+
+void World::setShipCount(int count)
+{
+    ShipState ship;
+    ship.x = 0;
+    ship.y = 0;
+    ship.velocityX = 0;
+    ship.velocityY = 0;
+    ship.rotation = 0;
+    ship.energy = START_ENERGY;
+    ship.alive = true;
+
+    m_ships.resize(count, ship);
+}
+
+void World::removeShip(int index)
+{
+    m_ships.erase(m_ships.begin() + index);
+
+    // Missiles from the removed ship go away, the rest need to point at the right owner and target
+    std::vector<MissileState> &missiles = detachMissiles();
+    size_t kept = 0;
+    for (size_t i=0; i<missiles.size(); i++) {
+        MissileState &missile = missiles[i];
+        if (missile.owner == index) {
+            continue;
+        }
+        if (missile.owner > index) {
+            missile.owner--;
+        }
+        if (missile.target == index) {
+            missile.target = -1;
+        } else if (missile.target > index) {
+            missile.target--;
+        }
+        missiles[kept++] = missile;
+    }
+    missiles.resize(kept);
+}
+
+void World::placeShips()
+{
+    const int shipCount = m_ships.size();
+    for (int i=0; i<shipCount; i++) {
+        ShipState &ship = m_ships[i];
+
+        double angle;
+        double radius;
+        if (shipCount <= PLACE_RING_MAX_SHIPS) {
+            angle = i * M_PI * 2.0 / shipCount;
+            radius = 0.5;
+        } else {
+            // Too many for one ring, so spread them out like the seeds in a sunflower,
+            // every ship getting the same amount of room between the inner and outer radius
+            angle = i * M_PI * (3.0 - sqrt(5.0));
+            radius = sqrt(PLACE_INNER_RADIUS * PLACE_INNER_RADIUS + (PLACE_OUTER_RADIUS * PLACE_OUTER_RADIUS - PLACE_INNER_RADIUS * PLACE_INNER_RADIUS) * (i + 0.5) / shipCount);
+        }
+        ship.x = cos(angle) * radius;
+        ship.y = sin(angle) * radius;
+
+        // Start out in orbit, the pull grows with the distance so the speed does too
+        const double velocityAngle = atan2(ship.y, ship.x) + M_PI_2;
+        ship.velocityX = cos(velocityAngle) / 35.0 * radius / 0.5;
+        ship.velocityY = sin(velocityAngle) / 35.0 * radius / 0.5;
+        setShipRotation(ship, int(velocityAngle * 360 / (M_PI * 2.0)));
+    }
+}
+
+void World::startRound()
+{
+    placeShips();
+
+    for (ShipState &ship : m_ships) {
+        ship.alive = true;
+        ship.energy = START_ENERGY;
+    }
+
+    clearMissiles();
+    m_hits.clear();
+    m_tick = 0;
+}
+
+void World::clearMissiles()
+{
+    if (m_missiles.use_count() > 1) {
+        m_missiles = std::make_shared<std::vector<MissileState>>();
+    } else {
+        m_missiles->clear();
+    }
+}
+
+bool World::step(const uint8_t *commands)
+{
+    const int shipCount = m_ships.size();
+
+    m_hits.clear();
+    m_appliedCommands.assign(shipCount, CommandNone);
+
+    // Only the ships near a missile can be hit by it, and seeking missiles
+    // find the closest one without looking at all of them
+    m_shipGrid.reset(std::min(int(sqrt(double(shipCount))), SHIP_GRID_MAX_CELLS));
+    for (int i=0; i<shipCount; i++) {
+        const ShipState &ship = m_ships[i];
+        if (ship.alive) {
+            m_shipGrid.insert(i, ship.x, ship.y);
+        }
+    }
+
+    std::vector<MissileState> &missiles = detachMissiles();
+    size_t kept = 0;
+    for (size_t m=0; m<missiles.size(); m++) {
+        MissileState &missile = missiles[m];
+
+        moveMissile(missile);
+
+        if (!missile.alive) {
+            continue;
+        }
+
+        // The grid goes across the edges, but hits don't, so check them the same way as always
+        // and in the order of the ships, in case it is close to more than one
+        m_nearShips.clear();
+        m_shipGrid.query(missile.x, missile.y, MISSILE_HIT_DISTANCE, &m_nearShips);
+        std::sort(m_nearShips.begin(), m_nearShips.end());
+
+        bool exploded = false;
+        for (int i : m_nearShips) {
+            ShipState &ship = m_ships[i];
+            if (!ship.alive) {
+                continue;
+            }
+
+            if (missile.owner == i) {
+                continue;
+            }
+
+            if (hypot(ship.x - missile.x, ship.y - missile.y) < MISSILE_HIT_DISTANCE) {
+                decreaseEnergy(ship, MISSILE_DAMAGE);
+                increaseEnergy(m_ships[missile.owner], MISSILE_DAMAGE);
+
+                Hit hit;
+                hit.ship = i;
+                hit.owner = missile.owner;
+                hit.x = missile.x;
+                hit.y = missile.y;
+                m_hits.push_back(hit);
+
+                exploded = true;
+                break;
+            }
+        }
+
+        if (exploded) {
+            continue;
+        }
+
+        if (missile.type == MissileSeeking) {
+            const bool targetGone = missile.target < 0 || missile.target >= shipCount || !m_ships[missile.target].alive;
+            if (targetGone || (uint32_t(m_tick) + missile.id) % SEEKING_RETARGET_INTERVAL == 0) {
+                // Ships hit by earlier missiles this tick can be dead already
+                const int owner = missile.owner;
+                const std::vector<ShipState> &ships = m_ships;
+                missile.target = m_shipGrid.nearest(missile.x, missile.y, 2.0, [owner, &ships](int index) {
+                    return index != owner && ships[index].alive;
+                });
+            }
+
+            if (missile.target >= 0) {
+                const ShipState &target = m_ships[missile.target];
+                setMissileRotation(missile, atan2(wrappedDelta(missile.y, target.y), wrappedDelta(missile.x, target.x)));
+            }
+        }
+
+        missiles[kept++] = missile;
+    }
+    missiles.resize(kept);
+    m_shipGrid.clear();
+
+    // Randomize the order we process ships in
+    m_order.resize(shipCount);
+    for (int i=0; i<shipCount; i++) {
+        m_order[i] = i;
+    }
+    for (int index = shipCount - 1; index > 0; --index) {
+        std::swap(m_order[index], m_order[m_random.bounded(index + 1)]);
+    }
+
+    int dead = 0;
+    for (int i : m_order) {
+        ShipState &ship = m_ships[i];
+        if (!ship.alive) {
+            dead++;
+            continue;
+        }
+
+        moveShip(ship);
+        decreaseEnergy(ship, 1);
+
+        const uint8_t command = commands[i];
+        switch (command) {
+        case CommandAccelerate:
+            accelerateShip(ship);
+            break;
+        case CommandLeft:
+            rotateShip(ship, -ROTATE_AMOUNT);
+            break;
+        case CommandRight:
+            rotateShip(ship, ROTATE_AMOUNT);
+            break;
+        case CommandMissile:
+            decreaseEnergy(ship, MISSILE_COST);
+            missiles.push_back(createMissile(MissileNormal, ship, i, m_nextMissileId++));
+            break;
+        case CommandSeeking:
+            decreaseEnergy(ship, SEEKING_MISSILE_COST);
+            missiles.push_back(createMissile(MissileSeeking, ship, i, m_nextMissileId++));
+            break;
+        case CommandMine:
+            decreaseEnergy(ship, MINE_COST);
+            missiles.push_back(createMissile(MissileMine, ship, i, m_nextMissileId++));
+            break;
+        default:
+            continue;
+        }
+
+        m_appliedCommands[i] = command;
+    }
+
+    m_tick++;
+
+    return dead > 0 && shipCount - dead < 2;
+}
+
+void World::setState(const std::vector<ShipState> &ships, const std::vector<MissileState> &missiles)
+{
+    m_ships = ships;
+    m_missiles = std::make_shared<std::vector<MissileState>>(missiles);
+    m_hits.clear();
+    m_appliedCommands.assign(m_ships.size(), CommandNone);
+}
+
+uint64_t World::digest() const
+{
+    StateDigest digest;
+
+    for (const ShipState &ship : m_ships) {
+        digest.addReal(ship.x);
+        digest.addReal(ship.y);
+        digest.addReal(ship.velocityX);
+        digest.addReal(ship.velocityY);
+        digest.addInteger(ship.rotation);
+        digest.addInteger(ship.energy);
+        digest.addInteger(ship.alive);
+    }
+
+    for (const MissileState &missile : *m_missiles) {
+        // The id decides when a seeking missile looks for a new target, and the target is kept until then
+        digest.addInteger(missile.id);
+        digest.addInteger(missile.target);
+        digest.addInteger(missile.type);
+        digest.addInteger(missile.owner);
+        digest.addReal(missile.x);
+        digest.addReal(missile.y);
+        digest.addReal(missile.velocityX);
+        digest.addReal(missile.velocityY);
+        digest.addReal(missile.rotation);
+        digest.addInteger(missile.energy);
+    }
+
+    return digest.value();
+}
+
+std::vector<MissileState> &World::detachMissiles()
+{
+    if (m_missiles.use_count() > 1) {
+        m_missiles = std::make_shared<std::vector<MissileState>>(*m_missiles);
+    }
+
+    return *m_missiles;
+}
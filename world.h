@@ -0,0 +1,144 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "pcg32.h"
+#include "spatialgrid.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The rules of the game, in plain C++ without Qt.
+// GameManager plays through this, and mirrors the state into the Player and
+// Missile objects that QML and the network code use.
+
+enum Command {
+    CommandNone = 0,
+    CommandAccelerate,
+    CommandLeft,
+    CommandRight,
+    CommandMissile,
+    CommandSeeking,
+    CommandMine
+};
+
+// Same values as Missile::Type
+enum MissileType {
+    MissileNormal = 0,
+    MissileMine,
+    MissileSeeking
+};
+
+// Hash of the values in parameters.h, changes whenever the rules do
+uint64_t rulesetHash();
+
+// The protocol names of commands, "ACCELERATE" etc.
+Command commandFromName(const char *name);
+const char *commandName(int command);
+
+struct ShipState
+{
+    double x;
+    double y;
+    double velocityX;
+    double velocityY;
+    int rotation; // degrees
+    int energy;
+    bool alive;
+};
+
+struct MissileState
+{
+    uint32_t id;
+    int type; // MissileType
+    int owner; // Index of the ship that fired it
+    int target; // Index of the ship a seeking missile is going for, -1 for none
+    double x;
+    double y;
+    double velocityX;
+    double velocityY;
+    double rotation; // radians
+    int energy;
+    bool alive;
+};
+
+// A missile hitting a ship
+struct Hit
+{
+    int ship;
+    int owner;
+    double x;
+    double y;
+};
+
+// Copying a World is cheap, so it can be branched off to simulate what
+// happens with different commands: the ships are copied straight away, while
+// the missiles are shared between the copies until one of them changes them.
+// Stepping moves every missile, so the first step of a branch copies them all.
+// A World is not thread safe, and neither are copies that still share their
+// missiles: keep them on the thread they were made on, or detach() them before
+// handing them to another thread.
+class World
+{
+public:
+    explicit World(uint64_t seed = 0);
+
+    // Reseeds, and restarts the missile ids. Call before the first round of a game.
+    void setSeed(uint64_t seed);
+
+    // Adds or removes ships at the end
+    void setShipCount(int count);
+    void removeShip(int index);
+
+    // Spreads the ships evenly around the sun, in orbit. Up to 16 go on one ring,
+    // more are spread out over the area around the sun.
+    void placeShips();
+
+    // Places the ships, gives them full energy and removes all missiles
+    void startRound();
+    void clearMissiles();
+
+    // Runs one game tick, with one command per ship.
+    // Returns true when the round is over.
+    bool step(const uint8_t *commands);
+
+    // Overwrites the state, for playing back recordings
+    void setState(const std::vector<ShipState> &ships, const std::vector<MissileState> &missiles);
+
+    const std::vector<ShipState> &ships() const { return m_ships; }
+    ShipState &ship(int index) { return m_ships[index]; }
+    const std::vector<MissileState> &missiles() const { return *m_missiles; }
+
+    // What happened in the last step
+    const std::vector<Hit> &hits() const { return m_hits; }
+    const std::vector<uint8_t> &appliedCommands() const { return m_appliedCommands; }
+
+    // Ticks stepped since the round started
+    int tick() const { return m_tick; }
+
+    // Gives this copy its own missiles, call it on the thread the copy was made on
+    void detach() { detachMissiles(); }
+
+    // Hash of the state of all ships and missiles
+    uint64_t digest() const;
+
+private:
+    // Makes our own copy of the missiles if they are shared with another World
+    std::vector<MissileState> &detachMissiles();
+
+    std::vector<ShipState> m_ships;
+    std::shared_ptr<std::vector<MissileState>> m_missiles;
+    std::vector<Hit> m_hits;
+    std::vector<uint8_t> m_appliedCommands;
+    std::vector<int> m_order;
+
+    // Where the alive ships are, only filled while stepping so copies stay cheap
+    SpatialGrid m_shipGrid;
+    std::vector<int> m_nearShips;
+
+    Pcg32 m_random;
+    uint32_t m_nextMissileId;
+    int m_tick;
+};
+
+#endif // WORLD_H